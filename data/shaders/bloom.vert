@@ -3,7 +3,7 @@ varying vec3 pos;
 
 void main()
 {
-    pos = gl_Vertex.xyz - gl_MultiTexCoord0.yzw;
+    pos = vec3(gl_Vertex.xy - gl_MultiTexCoord0.yz, 0.0);
     gl_TexCoord[0] = gl_MultiTexCoord0;
     gl_FrontColor = gl_Color;
     gl_Position = ftransform();
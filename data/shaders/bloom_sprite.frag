@@ -0,0 +1 @@
+#include "bloom.frag"
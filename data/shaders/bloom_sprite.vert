@@ -0,0 +1,15 @@
+attribute vec4 bloom_instance;
+attribute vec4 bloom_colour;
+
+varying vec3 pos;
+
+void main()
+{
+    float radius = bloom_instance.z;
+    vec2 offset  = (gl_Vertex.xy * 2.0 - 1.0) * radius;
+
+    pos = vec3(offset, 0.0);
+    gl_TexCoord[0] = vec4(radius, bloom_instance.xy, 0.0);
+    gl_FrontColor = bloom_colour;
+    gl_Position = gl_ModelViewProjectionMatrix * vec4(bloom_instance.xy + offset, 0.0, 1.0);
+}
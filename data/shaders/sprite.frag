@@ -0,0 +1,18 @@
+uniform sampler2D tex;
+uniform float shadow_strength;
+uniform float textured;
+
+void main(void)
+{
+    vec4 colour = gl_Color;
+
+    if(textured > 0.0) {
+        colour *= texture2D(tex,gl_TexCoord[0].st);
+    }
+
+    if(shadow_strength > 0.0) {
+        colour = vec4(0.0, 0.0, 0.0, colour.w * shadow_strength);
+    }
+
+    gl_FragColor = colour;
+}
@@ -0,0 +1,11 @@
+attribute vec4 sprite_rect;
+attribute vec4 sprite_colour;
+
+void main(void)
+{
+  vec2 corner = gl_Vertex.xy;
+
+  gl_TexCoord[0] = vec4(corner, 0.0, 1.0);
+  gl_FrontColor  = sprite_colour;
+  gl_Position    = gl_ModelViewProjectionMatrix * vec4(sprite_rect.xy + corner * sprite_rect.zw, 0.0, 1.0);
+}
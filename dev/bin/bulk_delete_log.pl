@@ -0,0 +1,44 @@
+#!/usr/bin/perl
+# generates a custom log for benchmarking a bulk directory delete while
+# many users still have actions pending against the deleted files.
+#
+# usage: bulk_delete_log.pl [--files 20000] [--users 300] > bulk-delete.log
+#        gource --log-format custom bulk-delete.log
+
+use strict;
+use warnings;
+
+use Getopt::Long qw(GetOptions);
+
+my $files = 20000;
+my $users = 300;
+my $dirs  = 200;
+
+GetOptions(
+    "files=i" => \$files,
+    "users=i" => \$users,
+    "dirs=i"  => \$dirs,
+) or die("usage: $0 [--files NUMBER] [--users NUMBER] [--dirs NUMBER]\n");
+
+my $timestamp = 1277787455;
+
+# create the files
+for(my $i = 0; $i < $files; $i++) {
+    my $dir = $i % $dirs;
+    printf("%d|user%d|A|bulk/dir%d/file%d.c\n", $timestamp, $i % $users, $dir, $i);
+}
+
+$timestamp += 60;
+
+# every user modifies every file so each has a long queue of pending actions
+for(my $u = 0; $u < $users; $u++) {
+    for(my $i = $u; $i < $files; $i += $users) {
+        my $dir = $i % $dirs;
+        printf("%d|user%d|M|bulk/dir%d/file%d.c\n", $timestamp, $u, $dir, $i);
+    }
+}
+
+# delete the whole directory while those actions are queued
+$timestamp += 1;
+
+printf("%d|user0|D|bulk/\n", $timestamp);
@@ -0,0 +1,149 @@
+#!/bin/sh
+# builds gource at each git revision given and times the same run of each,
+# for before and after numbers of a change.
+#
+# usage: compare_builds.sh [--export] LOG REV[:xvfb|:offscreen]... [-- GOURCE OPTIONS]
+#
+# :xvfb runs the build under xvfb-run, :offscreen adds --offscreen (builds
+# from before it was added do not support it). --export writes the video
+# (PPM, or y4m with --output-format y4m) and reports the exported frames per
+# second.
+#
+# eg. bulk directory delete before and after tracking actions per file:
+#   dev/bin/bulk_delete_log.pl > bulk-delete.log
+#   compare_builds.sh bulk-delete.log 0d9e9ec^:xvfb 0d9e9ec:xvfb -- --log-format custom --stop-at-end
+#
+# synchronous frame export against the capture pipeline:
+#   compare_builds.sh --export my-project.log 94e0edf^:xvfb 94e0edf:xvfb -- -1280x720 --stop-at-time 30
+#
+# Xvfb against offscreen rendering of the whole log (both stop at the end
+# when exporting; offscreen builds before 0543636 need --stop-at-time):
+#   compare_builds.sh --export my-project.log HEAD:xvfb HEAD:offscreen -- -1280x720
+
+set -e
+
+EXPORT=0
+
+if [ "$1" = "--export" ]; then
+    EXPORT=1
+    shift
+fi
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 [--export] LOG REV[:xvfb|:offscreen]... [-- GOURCE OPTIONS]"
+    exit 1
+fi
+
+LOG=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+shift
+
+VARIANTS=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    VARIANTS="$VARIANTS $1"
+    shift
+done
+
+[ "$1" = "--" ] && shift
+
+REPO=$(git rev-parse --show-toplevel)
+WORK=$(mktemp -d)
+
+cleanup() {
+    for tree in "$WORK"/build-*; do
+        [ -d "$tree" ] && git -C "$REPO" worktree remove --force "$tree"
+    done
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+# worktrees are checked out without the src/core submodule. initialise it
+# at the commit the revision records, falling back to the main checkout's
+# copy when the revision records none.
+core() {
+    git -C "$1" submodule update -q --init src/core > "$WORK/core.log" 2>&1 || true
+
+    if [ -z "$(ls -A "$1/src/core" 2>/dev/null)" ]; then
+        if [ -z "$(ls -A "$REPO/src/core" 2>/dev/null)" ]; then
+            cat "$WORK/core.log" >&2
+            echo "src/core is empty: run 'git submodule update --init' first" >&2
+            exit 1
+        fi
+
+        rm -rf "$1/src/core"
+        mkdir -p "$1/src"
+        ln -s "$REPO/src/core" "$1/src/core"
+    fi
+}
+
+build() {
+    tree="$WORK/build-$(git -C "$REPO" rev-parse --short "$1")"
+
+    if [ ! -x "$tree/gource" ]; then
+        git -C "$REPO" worktree add -q --detach "$tree" "$1"
+        core "$tree"
+        (cd "$tree" && ./autogen.sh && ./configure && make -j"$(nproc)" gource) > "$WORK/build.log" 2>&1 || {
+            cat "$WORK/build.log" >&2
+            echo "failed to build $1" >&2
+            exit 1
+        }
+    fi
+
+    echo "$tree/gource"
+}
+
+now() {
+    date +%s.%N
+}
+
+# run_gource MODE GOURCE [OPTIONS...]
+run_gource() {
+    run_mode=$1
+    run_bin=$2
+    shift 2
+
+    case "$run_mode" in
+        xvfb)      xvfb-run -a -s "-screen 0 1920x1080x24" "$run_bin" "$@" ;;
+        offscreen) "$run_bin" --offscreen "$@" ;;
+        *)         "$run_bin" "$@" ;;
+    esac
+}
+
+printf "%-24s %10s %10s\n" "build" "seconds" "fps"
+
+for variant in $VARIANTS; do
+    rev=${variant%%:*}
+    mode=
+    [ "$rev" != "$variant" ] && mode=${variant#*:}
+
+    gource=$(build "$rev") || exit 1
+
+    output="$WORK/export.ppm"
+
+    start=$(now)
+
+    if [ $EXPORT -eq 1 ]; then
+        run_gource "$mode" "$gource" -o "$output" "$@" "$LOG" > /dev/null
+    else
+        run_gource "$mode" "$gource" "$@" "$LOG" > /dev/null
+    fi
+
+    end=$(now)
+
+    fps=-
+    if [ $EXPORT -eq 1 ]; then
+        frames=$(grep -a -c "^# Generated by Gource$" "$output" || true)
+
+        # --output-format y4m
+        [ "$frames" -eq 0 ] && frames=$(grep -a -c "^FRAME$" "$output" || true)
+
+        if [ "$frames" -eq 0 ]; then
+            echo "$variant exported no frames" >&2
+            exit 1
+        fi
+
+        fps=$(echo "$frames $start $end" | awk '{ printf("%.2f", $1 / ($3 - $2)) }')
+        rm -f "$output"
+    fi
+
+    printf "%-24s %10.2f %10s\n" "$variant" "$(echo "$start $end" | awk '{ print $2 - $1 }')" "$fps"
+done
@@ -0,0 +1,48 @@
+#!/bin/sh
+# renders a few seconds of a generated log offscreen with Mesa's software
+# renderer and checks files and users were drawn as instanced sprites.
+#
+# usage: offscreen_smoke.sh [path to gource]
+
+set -e
+
+GOURCE=${1:-./gource}
+
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+i=0
+while [ $i -lt 200 ]; do
+    echo "$((1277787455 + i * 600))|user$((i % 5))|A|smoke/dir$((i % 10))/file$i.c" >> "$DIR/smoke.log"
+    i=$((i + 1))
+done
+
+LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe \
+    "$GOURCE" --offscreen --log-level debug --log-format custom \
+    -320x240 --stop-at-time 3 --seconds-per-day 1 \
+    -o "$DIR/smoke.ppm" "$DIR/smoke.log" > "$DIR/smoke.out" 2>&1 || {
+    cat "$DIR/smoke.out"
+    echo "offscreen render failed"
+    exit 1
+}
+
+if ! grep -q "instanced sprites" "$DIR/smoke.out"; then
+    cat "$DIR/smoke.out"
+    echo "files and users were not drawn as instanced sprites"
+    exit 1
+fi
+
+# the last frame should have more than the background in it
+perl -e '
+    local $/;
+    my $data = <STDIN>;
+    my $frame = 320 * 240 * 3;
+    my $pixels = substr($data, -$frame);
+    my $lit = () = $pixels =~ /[^\x00]/g;
+    exit($lit > 1000 ? 0 : 1);
+' < "$DIR/smoke.ppm" || {
+    echo "rendered frames are empty"
+    exit 1
+}
+
+echo "offscreen smoke render ok"
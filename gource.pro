@@ -32,9 +32,12 @@ VPATH += ./src
 
 SOURCES += \
     action.cpp \
+    benchmark.cpp \
     bloom.cpp \
     caption.cpp \
+    checkpoint.cpp \
     dirnode.cpp \
+    exporter.cpp \
     file.cpp \
     gource.cpp \
     gource_settings.cpp \
@@ -42,11 +45,19 @@ SOURCES += \
     key.cpp \
     logmill.cpp \
     main.cpp \
+    offscreen.cpp \
+    pathtrie.cpp \
     pawn.cpp \
+    pool.cpp \
     slider.cpp \
     spline.cpp \
+    sprites.cpp \
+    streambuffer.cpp \
     textbox.cpp \
+    tiles.cpp \
+    timerwheel.cpp \
     user.cpp \
+    yuv.cpp \
     zoomcamera.cpp \
     formats/apache.cpp \
     formats/bzr.cpp \
@@ -88,9 +99,12 @@ SOURCES += \
 
 HEADERS += \
     action.h \
+    benchmark.h \
     bloom.h \
     caption.h \
+    checkpoint.h \
     dirnode.h \
+    exporter.h \
     file.h \
     gource.h \
     gource_settings.h \
@@ -98,11 +112,19 @@ HEADERS += \
     key.h \
     logmill.h \
     main.h \
+    offscreen.h \
+    pathtrie.h \
     pawn.h \
+    pool.h \
     slider.h \
     spline.h \
+    sprites.h \
+    streambuffer.h \
     textbox.h \
+    tiles.h \
+    timerwheel.h \
     user.h \
+    yuv.h \
     zoomcamera.h \
     formats/apache.h \
     formats/bzr.h \
@@ -145,8 +167,12 @@ HEADERS += \
 
 DISTFILES += \
     data/shaders/bloom.frag \
+    data/shaders/bloom_sprite.frag \
     data/shaders/shadow.frag \
+    data/shaders/sprite.frag \
     data/shaders/text.frag \
     data/shaders/bloom.vert \
+    data/shaders/bloom_sprite.vert \
     data/shaders/shadow.vert \
+    data/shaders/sprite.vert \
     data/shaders/text.vert
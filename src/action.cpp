@@ -17,8 +17,24 @@
 
 #include "action.h"
 
+RObjectPool gGourceActionPool(std::max(sizeof(CreateAction), std::max(sizeof(RemoveAction), sizeof(ModifyAction))));
+
 RAction::RAction(RUser* source, RFile* target, time_t timestamp, float t, const vec3& colour)
-    : colour(colour), source(source), target(target), timestamp(timestamp), t(t), progress(0.0f), rate(0.5f) {
+    : colour(colour), source(source), target(target), timestamp(timestamp), t(t), progress(0.0f), rate(0.5f), active(false) {
+
+    target_position = target->addAction(this);
+}
+
+RAction::~RAction() {
+    target->removeAction(target_position);
+}
+
+void* RAction::operator new(size_t size) {
+    return gGourceActionPool.allocate(size);
+}
+
+void RAction::operator delete(void* action) {
+    gGourceActionPool.release(action);
 }
 
 void RAction::apply() {
@@ -104,6 +120,7 @@ CreateAction::CreateAction(RUser* source, RFile* target, time_t timestamp, float
 
 RemoveAction::RemoveAction(RUser* source, RFile* target, time_t timestamp, float t)
     : RAction(source, target, timestamp, t, vec3(1.0f, 0.0f, 0.0f)) {
+    target->setRemovePending();
 }
 
 void RemoveAction::logic(float dt) {
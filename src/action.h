@@ -20,6 +20,7 @@
 
 #include "user.h"
 #include "file.h"
+#include "pool.h"
 
 class RUser;
 class RFile;
@@ -38,8 +39,16 @@ public:
     float progress;
     float rate;
 
+    //position in the source user's action lists and in the target file's list of actions
+    std::list<RAction*>::iterator source_position;
+    std::list<RAction*>::iterator target_position;
+    bool active;
+
     RAction(RUser* source, RFile* target, time_t timestamp, float t, const vec3& colour);
-    virtual ~RAction() {};
+    virtual ~RAction();
+
+    static void* operator new(size_t size);
+    static void operator delete(void* action);
     
     inline bool isFinished() const { return (progress >= 1.0); };
 
@@ -70,5 +79,7 @@ public:
     void apply();
 };
 
+extern RObjectPool gGourceActionPool;
+
 #endif
 
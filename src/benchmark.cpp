@@ -0,0 +1,138 @@
+/*
+    Copyright (C) 2010 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+GourceBenchmark::GourceBenchmark(float dt) : dt(dt) {
+    peak_files = peak_dirs = peak_users = peak_actions = 0;
+    load_time = run_time = 0.0;
+    frames = 0;
+    heap_allocations = 0;
+}
+
+void GourceBenchmark::run() {
+
+    //camera and key layout still depend on the viewport size
+    display.width  = gGourceSettings.display_width  > 0 ? gGourceSettings.display_width  : 1024;
+    display.height = gGourceSettings.display_height > 0 ? gGourceSettings.display_height : 768;
+
+    gGourceSettings.repo_count  = 1;
+    gGourceSettings.stop_at_end = true;
+    gGourceSettings.loop        = false;
+
+    Uint64 freq  = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    Gource* gource = new Gource();
+
+    while(gource->isLoading()) {
+        SDL_Delay(1);
+    }
+
+    Uint64 loaded = SDL_GetPerformanceCounter();
+
+    Uint64 simulated = 0;
+
+#ifdef GOURCE_ALLOCATION_STATS
+    size_t heap_start = RObjectPool::heapAllocationCount();
+#endif
+
+    while(!gource->isFinished()) {
+        Uint64 frame_start = SDL_GetPerformanceCounter();
+
+        gource->simulate(dt);
+        frames++;
+
+        simulated += SDL_GetPerformanceCounter() - frame_start;
+
+        //sampled outside the timed part of the frame
+        peak_files   = std::max(peak_files,   gource->getFileCount());
+        peak_dirs    = std::max(peak_dirs,    gource->getDirCount());
+        peak_users   = std::max(peak_users,   gource->getUserCount());
+        peak_actions = std::max(peak_actions, gGourceActionPool.objectsInUse());
+    }
+
+#ifdef GOURCE_ALLOCATION_STATS
+    heap_allocations = RObjectPool::heapAllocationCount() - heap_start;
+#endif
+
+    load_time = (loaded - start)    / (double) freq;
+    run_time  = simulated / (double) freq;
+
+    report(gource);
+
+    delete gource;
+}
+
+void GourceBenchmark::report(Gource* gource) {
+
+    int commits      = gource->getProcessedCommits();
+    int commit_files = gource->getProcessedCommitFiles();
+
+    double per_second = run_time > 0.0 ? 1.0 / run_time : 0.0;
+
+    printf("Benchmark: %s\n\n", gGourceSettings.path.c_str());
+
+    printf("  frames            %d (%.2f simulated seconds at %.0f fps)\n", frames, frames * dt, 1.0f / dt);
+    printf("  log load time     %.3f s\n", load_time);
+    printf("  simulation time   %.3f s (%.3f ms/frame)\n", run_time, frames > 0 ? run_time * 1000.0 / frames : 0.0);
+    printf("  commits           %d (%.1f/s)\n", commits, commits * per_second);
+    printf("  commit files      %d (%.1f/s)\n", commit_files, commit_files * per_second);
+    printf("  peak files        %lu\n", (unsigned long) peak_files);
+    printf("  peak dirs         %lu\n", (unsigned long) peak_dirs);
+    printf("  peak users        %lu\n", (unsigned long) peak_users);
+    printf("  peak actions      %lu\n", (unsigned long) peak_actions);
+
+#ifdef GOURCE_ALLOCATION_STATS
+    printf("  heap allocations  %lu (%.1f/frame)\n", (unsigned long) heap_allocations, frames > 0 ? heap_allocations / (double) frames : 0.0);
+#endif
+
+#ifndef _WIN32
+    struct rusage usage;
+
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        double max_rss_mb = usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        double max_rss_mb = usage.ru_maxrss / 1024.0;
+#endif
+        printf("  max resident set  %.1f MB\n", max_rss_mb);
+    }
+#endif
+
+    printf("\n  %-18s %10s %12s %7s\n", "phase", "total (s)", "ms/frame", "share");
+
+    double total = 0.0;
+
+    for(int i = 0; i < GOURCE_PHASE_COUNT; i++) {
+        total += gource->getPhaseSeconds(i);
+    }
+
+    for(int i = 0; i < GOURCE_PHASE_COUNT; i++) {
+        double seconds = gource->getPhaseSeconds(i);
+
+        printf("  %-18s %10.3f %12.4f %6.1f%%\n",
+            Gource::getPhaseName(i),
+            seconds,
+            frames > 0 ? seconds * 1000.0 / frames : 0.0,
+            total > 0.0 ? seconds * 100.0 / total : 0.0);
+    }
+}
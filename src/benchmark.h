@@ -0,0 +1,47 @@
+/*
+    Copyright (C) 2010 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GOURCE_BENCHMARK_H
+#define GOURCE_BENCHMARK_H
+
+#include "gource.h"
+
+// Runs the simulation over the whole log with a fixed time step and no
+// window, GL context or drawing, then reports where the time went.
+
+class GourceBenchmark {
+    float dt;
+
+    size_t peak_files;
+    size_t peak_dirs;
+    size_t peak_users;
+    size_t peak_actions;
+
+    double load_time;
+    double run_time;
+    int frames;
+
+    size_t heap_allocations;
+
+    void report(Gource* gource);
+public:
+    GourceBenchmark(float dt = 1.0f / 60.0f);
+
+    void run();
+};
+
+#endif
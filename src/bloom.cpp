@@ -20,9 +20,9 @@
 //bloombuf
 
 bloombuf::bloombuf(int data_size) : data_size(data_size) {
-    bufferid     = 0;
-    buffer_size  = 0;
-    vertex_count = 0;
+    buffer_offset = 0;
+    vertex_count  = 0;
+    instanced     = false;
 
     data = data_size > 0 ? new bloom_vertex[data_size] : 0;
 
@@ -30,7 +30,6 @@ bloombuf::bloombuf(int data_size) : data_size(data_size) {
 }
 
 bloombuf::~bloombuf() {
-    if(bufferid !=0) glDeleteBuffers(1, &bufferid);
     if(data != 0) delete[] data;
 }
 
@@ -51,12 +50,13 @@ void bloombuf::resize(int new_size) {
 
 void bloombuf::reset() {
     vertex_count = 0;
+    instances.clear();
 }
 
 void bloombuf::unload() {
-    if(bufferid !=0) glDeleteBuffers(1, &bufferid);
-    bufferid = 0;
-    buffer_size = 0;
+    buffer.unload();
+    quad.unload();
+    buffer_offset = 0;
 }
 
 size_t bloombuf::vertices() {
@@ -67,12 +67,29 @@ size_t bloombuf::capacity() {
     return data_size;
 }
 
-void bloombuf::add(GLuint textureid, const vec2& pos, const vec2& dims, const vec4& colour, const vec4& texcoord) {
+size_t bloombuf::quads() {
+    return instanced ? instances.size() : vertex_count / 4;
+}
+
+void bloombuf::setInstanced(bool instanced) {
+    this->instanced = instanced;
+    reset();
+}
+
+void bloombuf::add(GLuint textureid, const vec2& pos, const vec2& dims, const vec4& colour, const vec3& texcoord) {
+
+    GLuint packed = packColour(colour);
+
+    //the shader builds the quad from the centre and radius
+    if(instanced) {
+        instances.push_back(bloom_instance(vec2(texcoord.y, texcoord.z), texcoord.x, packed));
+        return;
+    }
 
-    bloom_vertex v1(pos,                       colour, texcoord);
-    bloom_vertex v2(pos + vec2(dims.x, 0.0f), colour, texcoord);
-    bloom_vertex v3(pos + dims,                colour, texcoord);
-    bloom_vertex v4(pos + vec2(0.0f, dims.y), colour, texcoord);
+    bloom_vertex v1(pos,                       packed, texcoord);
+    bloom_vertex v2(pos + vec2(dims.x, 0.0f), packed, texcoord);
+    bloom_vertex v3(pos + dims,                packed, texcoord);
+    bloom_vertex v4(pos + vec2(0.0f, dims.y), packed, texcoord);
 
     int i = vertex_count;
 
@@ -89,38 +106,69 @@ void bloombuf::add(GLuint textureid, const vec2& pos, const vec2& dims, const ve
 }
 
 void bloombuf::update() {
-    if(vertex_count==0) return;
 
-    //note possibly better to have a queue and cycle them here
-    if(bufferid==0) {
-        glGenBuffers(1, &bufferid);
+    if(instanced) {
+        if(!instances.empty()) buffer_offset = buffer.upload(&(instances[0]), instances.size()*sizeof(bloom_instance));
+        return;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, bufferid);
+    if(vertex_count==0) return;
 
-    //recreate buffer if less than the vertex_count
-    if(buffer_size < vertex_count) {
-        buffer_size = data_size;
-        glBufferData(GL_ARRAY_BUFFER, buffer_size*sizeof(bloom_vertex), &(data[0].pos.x), GL_DYNAMIC_DRAW);
-    } else {
-        glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_count*sizeof(bloom_vertex), &(data[0].pos.x));
-    }
+    buffer_offset = buffer.upload(&(data[0].pos.x), vertex_count*sizeof(bloom_vertex));
+}
+
+void bloombuf::drawInstances() {
+    if(instances.empty()) return;
+
+    GLint instance_attrib = RInstancedQuad::attribute("bloom_instance");
+    GLint colour_attrib   = RInstancedQuad::attribute("bloom_colour");
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if(instance_attrib < 0 || colour_attrib < 0) return;
+
+    quad.bind();
+
+    buffer.bind();
+
+    glEnableVertexAttribArray(instance_attrib);
+    glEnableVertexAttribArray(colour_attrib);
+
+    glVertexAttribDivisorARB(instance_attrib, 1);
+    glVertexAttribDivisorARB(colour_attrib,   1);
+
+    glVertexAttribPointer(instance_attrib, 3, GL_FLOAT,         GL_FALSE, sizeof(bloom_instance), (GLvoid*)(buffer_offset));
+    glVertexAttribPointer(colour_attrib,   4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(bloom_instance), (GLvoid*)(buffer_offset+12)); // offset pos + radius (3x4 bytes)
+
+    quad.draw(instances.size());
+
+    glVertexAttribDivisorARB(instance_attrib, 0);
+    glVertexAttribDivisorARB(colour_attrib,   0);
+
+    glDisableVertexAttribArray(instance_attrib);
+    glDisableVertexAttribArray(colour_attrib);
+
+    buffer.unbind();
+
+    quad.unbind();
 }
 
 void bloombuf::draw() {
-    if(vertex_count==0 || bufferid==0) return;
 
-    glBindBuffer(GL_ARRAY_BUFFER, bufferid);
+    if(instanced) {
+        drawInstances();
+        return;
+    }
+
+    if(vertex_count==0) return;
+
+    buffer.bind();
 
     glEnableClientState(GL_VERTEX_ARRAY);
     glEnableClientState(GL_COLOR_ARRAY);
     glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 
-    glVertexPointer(2,   GL_FLOAT, sizeof(bloom_vertex), 0);
-    glColorPointer(4,    GL_FLOAT, sizeof(bloom_vertex), (GLvoid*)8);  // offset pos (2x4 bytes)
-    glTexCoordPointer(4, GL_FLOAT, sizeof(bloom_vertex), (GLvoid*)24); // offset pos + colour (2x4 + 4x4 bytes)
+    glVertexPointer(2,   GL_FLOAT, sizeof(bloom_vertex), (GLvoid*)(buffer_offset));
+    glColorPointer(4,    GL_UNSIGNED_BYTE, sizeof(bloom_vertex), (GLvoid*)(buffer_offset+8));  // offset pos (2x4 bytes)
+    glTexCoordPointer(3, GL_FLOAT, sizeof(bloom_vertex), (GLvoid*)(buffer_offset+12)); // offset pos + colour (2x4 + 4 bytes)
 
     glDrawArrays(GL_QUADS, 0, vertex_count);
 
@@ -128,5 +176,5 @@ void bloombuf::draw() {
     glDisableClientState(GL_COLOR_ARRAY);
     glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    buffer.unbind();
 }
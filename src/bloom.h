@@ -24,17 +24,31 @@
 #include "core/vectors.h"
 #include "core/logger.h"
 
-//note this should be 64 bytes
+#include "streambuffer.h"
+#include "sprites.h"
+
+//24 bytes: position, normalized byte colour and (radius, centre) texcoord
 class bloom_vertex {
 public:
     bloom_vertex() {};
-    bloom_vertex(const vec2& pos, const vec4& colour, const vec4& texcoord) :
+    bloom_vertex(const vec2& pos, GLuint colour, const vec3& texcoord) :
         pos(pos), colour(colour), texcoord(texcoord) {};
 
     vec2 pos;
-    vec4 colour;
-    vec4 texcoord;
-    char padding[24];
+    GLuint colour;
+    vec3 texcoord;
+};
+
+//one record per bloom quad for the instanced bloom shader (16 bytes)
+class bloom_instance {
+public:
+    bloom_instance() {};
+    bloom_instance(const vec2& pos, float radius, GLuint colour) :
+        pos(pos), radius(radius), colour(colour) {};
+
+    vec2 pos;
+    float radius;
+    GLuint colour;
 };
 
 class bloombuf {
@@ -42,12 +56,17 @@ class bloombuf {
     bloom_vertex* data;
     int data_size;
 
-    GLuint bufferid;
-    int buffer_size;
+    bool instanced;
+    std::vector<bloom_instance> instances;
+    RInstancedQuad quad;
+
+    RStreamBuffer buffer;
+    size_t buffer_offset;
 
     int vertex_count;
 
     void resize(int new_size);
+    void drawInstances();
 public:
     bloombuf(int data_size = 0);
     ~bloombuf();
@@ -55,10 +74,17 @@ public:
     void unload();
     void reset();
 
+    // draw each quad as an instance, with a shader taking bloom_instance and bloom_colour attributes
+    void setInstanced(bool instanced);
+    bool isInstanced() const { return instanced; };
+
     size_t vertices();
+    size_t quads();
     size_t capacity();
 
-    void add(GLuint textureid, const vec2& pos, const vec2& dims, const vec4& colour, const vec4& texcoord);
+    bool persistent() const { return buffer.isPersistent(); };
+
+    void add(GLuint textureid, const vec2& pos, const vec2& dims, const vec4& colour, const vec3& texcoord);
 
     void update();
     void draw();
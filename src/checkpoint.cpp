@@ -0,0 +1,41 @@
+/*
+    Copyright (C) 2010 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "checkpoint.h"
+
+//RCheckpointPaths
+
+unsigned int RCheckpointPaths::intern(const std::string& path) {
+
+    std::unordered_map<std::string, unsigned int>::iterator it = ids.find(path);
+
+    if(it != ids.end()) return it->second;
+
+    unsigned int id = paths.size();
+
+    it = ids.insert(std::make_pair(path, id)).first;
+
+    //keys of an unordered_map don't move when it rehashes
+    paths.push_back(&(it->first));
+
+    return id;
+}
+
+void RCheckpointPaths::clear() {
+    ids.clear();
+    paths.clear();
+}
@@ -0,0 +1,77 @@
+/*
+    Copyright (C) 2010 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RCHECKPOINT_H
+#define RCHECKPOINT_H
+
+#include "formats/commitlog.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+// Compact snapshot of the simulation taken at a commit boundary: the live
+// files and their colours, the directory layout and where the next commit
+// starts in the log. Used to restore the scene when seeking.
+//
+// Paths are stored as ids into an RCheckpointPaths table shared by all the
+// checkpoints, so a path present in every checkpoint is only stored once.
+
+class RCheckpointPaths {
+    std::unordered_map<std::string, unsigned int> ids;
+    std::vector<const std::string*> paths;
+public:
+    unsigned int intern(const std::string& path);
+
+    const std::string& getPath(unsigned int id) const { return *(paths[id]); };
+
+    size_t size() const { return paths.size(); };
+
+    void clear();
+};
+
+class RCheckpointFile {
+public:
+    unsigned int path;
+    vec3 colour;
+
+    RCheckpointFile(unsigned int path, const vec3& colour) : path(path), colour(colour) {};
+};
+
+class RCheckpointDir {
+public:
+    unsigned int path;
+    vec2 pos;
+
+    RCheckpointDir(unsigned int path, const vec2& pos) : path(path), pos(pos) {};
+};
+
+class RCheckpoint {
+public:
+    // checkpoint can be used when seeking to or beyond this point
+    float percent;
+
+    // log position to replay commits from after restoring
+    RCommitLogPosition position;
+
+    std::vector<RCheckpointFile> files;
+    std::vector<RCheckpointDir>  dirs;
+
+    RCheckpoint() : percent(0.0f) {};
+};
+
+#endif
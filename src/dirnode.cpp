@@ -29,7 +29,10 @@ bool  gGourceGravity      = true;
 int  gGourceDirNodeInnerLoops = 0;
 int  gGourceFileInnerLoops = 0;
 
-std::map<std::string, RDirNode*> gGourceDirMap;
+RObjectPool gGourceDirNodePool(sizeof(RDirNode));
+
+//unit vectors of the file slots in a ring of each size, shared by all directories
+std::vector< std::vector<vec2> > gGourceRingLayouts;
 
 RDirNode::RDirNode(RDirNode* parent, const std::string & abspath) {
 
@@ -57,6 +60,15 @@ RDirNode::RDirNode(RDirNode* parent, const std::string & abspath) {
     file_area  = padded_file_radius * padded_file_radius * PI;
 
     visible_count = 0;
+    layout_count  = -1;
+
+    aggregates_dirty = true;
+    total_file_count = 0;
+    total_dir_count  = 1;
+
+    lod_expand       = 1.0f;
+    lod_alpha        = 1.0f;
+    lod_parent_alpha = 1.0f;
 
     visible = false;
     position_initialized = false;
@@ -72,7 +84,7 @@ RDirNode::RDirNode(RDirNode* parent, const std::string & abspath) {
 void RDirNode::changePath(const std::string & abspath) {
     //fix up path
 
-    gGourceDirMap.erase(this->abspath);
+    if(!this->abspath.empty()) gGourceDirTrie.remove(this->abspath);
     this->abspath = abspath;
 
     if(abspath.empty() || abspath[abspath.size()-1] != '/') {
@@ -81,7 +93,7 @@ void RDirNode::changePath(const std::string & abspath) {
 
     //debugLog("new dirnode %s\n", abspath.c_str());
 
-    gGourceDirMap[this->abspath] = this;
+    gGourceDirTrie.add(this->abspath, this);
 }
 
 RDirNode::~RDirNode() {
@@ -89,7 +101,15 @@ RDirNode::~RDirNode() {
         delete (*it);
     }
 
-    gGourceDirMap.erase(abspath);
+    gGourceDirTrie.remove(abspath);
+}
+
+void* RDirNode::operator new(size_t size) {
+    return gGourceDirNodePool.allocate(size);
+}
+
+void RDirNode::operator delete(void* node) {
+    gGourceDirNodePool.release(node);
 }
 
 int RDirNode::getTokenOffset() const{
@@ -97,7 +117,7 @@ int RDirNode::getTokenOffset() const{
 }
 
 void RDirNode::fileUpdated(bool userInitiated) {
-    calcRadius();
+    updateFilePositions();
 
     since_last_file_change = 0.0;
 
@@ -107,12 +127,51 @@ void RDirNode::fileUpdated(bool userInitiated) {
 void RDirNode::nodeUpdated(bool userInitiated) {
     if(userInitiated) since_last_node_change = 0.0;
 
-    calcRadius();
-    updateFilePositions();
+    markDirty();
+
     if(visible && noDirs() && noFiles()) visible = false;
     if(parent !=0) parent->nodeUpdated(true);
 }
 
+//flag this node and its ancestors as needing their aggregates recalculated.
+//stops at the first node already flagged as its ancestors will be too.
+void RDirNode::markDirty() {
+    for(RDirNode* node = this; node != 0 && !node->aggregates_dirty; node = node->parent) {
+        node->aggregates_dirty = true;
+    }
+}
+
+//recalculate cached subtree totals and radius, only visiting dirty nodes
+void RDirNode::updateAggregates() {
+    if(!aggregates_dirty) return;
+
+    total_file_count = visible_count;
+    total_dir_count  = 1;
+    file_colour_sum  = vec3(0.0f);
+
+    for(std::list<RFile*>::const_iterator it = files.begin(); it != files.end(); it++) {
+        RFile* file = (*it);
+
+        if(file->isHidden()) continue;
+
+        file_colour_sum += file->getFileColour();
+    }
+
+    for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
+        RDirNode* node = (*it);
+
+        node->updateAggregates();
+
+        total_file_count += node->total_file_count;
+        total_dir_count  += node->total_dir_count;
+        file_colour_sum  += node->file_colour_sum;
+    }
+
+    calcRadius();
+
+    aggregates_dirty = false;
+}
+
 void RDirNode::rotate(float s, float c) {
     pos  = rotate_vec2(pos,  s, c);
     spos = rotate_vec2(spos, s, c);
@@ -138,6 +197,13 @@ void RDirNode::setPos(const vec2 & pos) {
     this->pos = pos;
 }
 
+//place the node at a known position instead of near its parent
+void RDirNode::setInitialPos(const vec2 & pos) {
+    this->pos  = pos;
+    this->spos = pos;
+    position_initialized = true;
+}
+
 //returns true if supplied path prefixes the nodes path
 bool RDirNode::prefixedBy(const std::string & path) const {
     if(path.empty()) return false;
@@ -157,32 +223,6 @@ RDirNode* RDirNode::getParent() const{
 }
 
 
-bool RDirNode::isDir(const std::string& path) const {
-
-    if(prefixedBy(path)) return true;
-
-    if(path.find(abspath) != 0) return false;
-
-    for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
-        if((*it)->isDir(path)) return true;
-    }
-
-    return false;
-}
-
-//finds directories closest to the root directory prefixed by path (eg foo/ may match just foo/ or could also match foo/bar1, foo/bar2, ... if foo/ doesn't exist).
-void RDirNode::findDirs(const std::string& path, std::list<RDirNode*>& dirs) {
-
-    if(prefixedBy(path)) {
-        dirs.push_back(this);
-        return;
-    }
-
-    for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
-        (*it)->findDirs(path, dirs);
-    }
-}
-
 void RDirNode::getFilesRecursive(std::list<RFile*>& files) const {
 
     //add this dirs files
@@ -261,6 +301,8 @@ void RDirNode::addNode(RDirNode* node) {
     children.push_back(node);
     node->setParent(this);
 
+    if(node->visible) setVisible();
+
     //debugLog("added node %s to %s\n", node->getPath().c_str(), getPath().c_str());
 
     nodeUpdated(false);
@@ -330,21 +372,20 @@ void RDirNode::printFiles() {
 
 void RDirNode::addVisible() {
     visible_count++;
-    visible = true;
+    setVisible();
+    markDirty();
 }
 
-bool RDirNode::isVisible() {
-
-    if(visible) return true;
-
-    for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
-        if((*it)->isVisible()) {
-            visible = true;
-            return true;
-        }
+//a node is visible if it or any of its descendants has ever had a visible file,
+//so visibility is pushed up to ancestors rather than searched for on demand.
+void RDirNode::setVisible() {
+    for(RDirNode* node = this; node != 0 && !node->visible; node = node->parent) {
+        node->visible = true;
     }
+}
 
-    return false;
+bool RDirNode::isVisible() {
+    return visible;
 }
 
 int RDirNode::visibleFileCount() const{
@@ -374,6 +415,20 @@ std::string RDirNode::commonPathPrefix(const std::string & str) const{
     return str.substr(0,slash+1);
 }
 
+//add files whose path is this directory, laying them out once
+void RDirNode::addFiles(std::vector<RFile*>::const_iterator begin, std::vector<RFile*>::const_iterator end) {
+
+    for(std::vector<RFile*>::const_iterator it = begin; it != end; it++) {
+        RFile* f = *it;
+
+        files.push_back(f);
+        if(!f->isHidden()) visible_count++;
+        f->setDir(this);
+    }
+
+    fileUpdated(false);
+}
+
 bool RDirNode::addFile(RFile* f) {
 
     //doesnt match this path at all
@@ -419,12 +474,10 @@ bool RDirNode::addFile(RFile* f) {
     bool added = false;
 
     //does this belong to one of the children ?
-    for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
-        RDirNode* child =  (*it);
-
-        added = child->addFile(f);
+    RDirNode* closest = gGourceDirTrie.findClosest(f->path);
 
-        if(added) break;
+    if(closest != 0 && closest != this) {
+        added = closest->addFile(f);
     }
 
     if(added && parent != 0) return true;
@@ -445,6 +498,10 @@ bool RDirNode::addFile(RFile* f) {
 
     if(added) return true;
 
+    // do we have dir nodes, with a common path element greater than abspath,
+    // if so create another node, and move those nodes there
+    std::string commonpath = gGourceDirTrie.commonPrefix(f->path);
+
     //add new child, add it to that
     //if commonpath is longer than abspath, add intermediate node, else just add at the files path
     RDirNode* node = new RDirNode(this, f->path);
@@ -453,26 +510,20 @@ bool RDirNode::addFile(RFile* f) {
 
     addNode(node);
 
-    // do we have dir nodes, with a common path element greater than abspath,
-    // if so create another node, and move those nodes there
-
-     std::string commonpath;
-     vec2 commonPos;
-     for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
-         RDirNode* child =  (*it);
-
-         std::string common = child->commonPathPrefix(f->path);
-         if(common.size() > abspath.size() && common != f->path) {
-            commonpath = common;
-            commonPos = child->getPos();
-            break;
-         }
-     }
-
     // redistribute to new common node
-    if(commonpath.size() > abspath.size()) {
+    if(commonpath.size() > abspath.size() && commonpath != f->path) {
         //debugLog("common path %s\n", commonpath.c_str());
 
+        vec2 commonPos;
+        for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
+            RDirNode* child =  (*it);
+
+            if(child != node && child->prefixedBy(commonpath)) {
+                commonPos = child->getPos();
+                break;
+            }
+        }
+
         RDirNode* cnode = new RDirNode(this, commonpath);
         cnode->setPos(commonPos);
 
@@ -495,47 +546,58 @@ bool RDirNode::addFile(RFile* f) {
     return true;
 }
 
-float RDirNode::getParentRadius() const{
-    return parent_radius;
+//collapse directories that are too small on screen to make out into a single
+//node, fading between it and the directory contents as the camera zooms.
+void RDirNode::updateDetail(float pixels_per_unit, float dt) {
+    updateDetail(pixels_per_unit, 1.0f, dt);
 }
 
-float RDirNode::getRadius() const{
-    return dir_radius;
-}
-
-float RDirNode::getRadiusSqrt() const{
-    return dir_radius_sqrt;
-}
+void RDirNode::updateDetail(float pixels_per_unit, float parent_alpha, float dt) {
 
-vec3 RDirNode::averageFileColour() const{
+    float target = 1.0f;
 
-    vec3 av;
-    int count = 0;
+    if(parent != 0 && gGourceSettings.lod_threshold > 0.0f && dir_radius * 2.0f * pixels_per_unit < gGourceSettings.lod_threshold) {
+        target = 0.0f;
+    }
 
-    for(std::list<RFile*>::const_iterator it = files.begin(); it != files.end(); it++) {
-        RFile* file = (*it);
+    if(lod_expand < target) {
+        lod_expand = std::min(target, lod_expand + dt * 2.0f);
+    } else if(lod_expand > target) {
+        lod_expand = std::max(target, lod_expand - dt * 2.0f);
+    }
 
-        if(file->isHidden()) continue;
+    lod_parent_alpha = parent_alpha;
+    lod_alpha        = parent_alpha * lod_expand;
 
-        av += file->getColour();
+    for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
+        RDirNode* node = (*it);
 
-        count++;
+        node->updateDetail(pixels_per_unit, lod_alpha, dt);
     }
+}
 
-    if(count>0) av *= (1.0f/(float)count);
+//true if the contents of this directory are not being shown
+bool RDirNode::isCollapsed() const{
+    return lod_alpha <= 0.0f;
+}
 
-    count = 0;
+float RDirNode::getParentRadius() const{
+    return parent_radius;
+}
 
-    for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end();it++) {
-            RDirNode* child =  (*it);
+float RDirNode::getRadius() const{
+    return dir_radius;
+}
 
-            av += child->averageFileColour();
-            count++;
-    }
+float RDirNode::getRadiusSqrt() const{
+    return dir_radius_sqrt;
+}
 
-    if(count>0) av *= (1.0f/(float)count);
+//average colour of the visible files in this subtree as of the last updateAggregates()
+vec3 RDirNode::averageFileColour() const{
+    if(total_file_count == 0) return vec3(0.0f);
 
-    return av;
+    return file_colour_sum * (1.0f/(float)total_file_count);
 }
 
 const vec4 & RDirNode::getColour() const{
@@ -549,6 +611,15 @@ void RDirNode::calcColour() {
 
     col = vec4(brightness, brightness, brightness, 1.0);
 
+    //use the cached average rather than visiting the files of collapsed directories
+    if(isCollapsed()) {
+        vec3 filecol = averageFileColour() * brightness * (float) visible_count;
+
+        col += vec4(filecol.x, filecol.y, filecol.z, (float) visible_count);
+        col /= (float) visible_count + 1.0;
+        return;
+    }
+
     int fcount = 0;
 
     for(std::list<RFile*>::iterator it = files.begin(); it != files.end(); it++) {
@@ -726,25 +797,11 @@ void RDirNode::debug(int indent) const{
 }
 
 int RDirNode::totalFileCount() const{
-    int total = visibleFileCount();
-
-    for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
-        RDirNode* node = (*it);
-        total += node->visibleFileCount();
-    }
-
-    return total;
+    return total_file_count;
 }
 
 int RDirNode::totalDirCount() const{
-    int total = 1;
-
-    for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
-        RDirNode* node = (*it);
-        total += node->totalDirCount();
-    }
-
-    return total;
+    return total_dir_count;
 }
 
 int RDirNode::dirCount() const{
@@ -839,8 +896,30 @@ vec2 RDirNode::calcFileDest(int max_files, int file_no) {
     return dest;
 }
 
+const std::vector<vec2>& RDirNode::getRingLayout(int max_files) {
+
+    if((size_t) max_files >= gGourceRingLayouts.size()) gGourceRingLayouts.resize(max_files+1);
+
+    std::vector<vec2>& ring = gGourceRingLayouts[max_files];
+
+    if(ring.empty()) {
+        ring.reserve(max_files);
+
+        for(int i = 0; i < max_files; i++) {
+            ring.push_back(calcFileDest(max_files, i));
+        }
+    }
+
+    return ring;
+}
+
 void RDirNode::updateFilePositions() {
 
+    //files only move to a different slot when the number of visible files changes
+    if(visible_count == layout_count) return;
+
+    layout_count = visible_count;
+
     int max_files = 1;
     int diameter  = 1;
     int file_no   = 0;
@@ -848,6 +927,8 @@ void RDirNode::updateFilePositions() {
 
     int files_left = visible_count;
 
+    const std::vector<vec2>* ring = &getRingLayout(max_files);
+
     for(std::list<RFile*>::iterator it = files.begin(); it!=files.end(); it++) {
         RFile* f = *it;
 
@@ -857,9 +938,7 @@ void RDirNode::updateFilePositions() {
             continue;
         }
 
-        vec2 dest = calcFileDest(max_files, file_no);
-
-        f->setDest(dest);
+        f->setDest((*ring)[file_no]);
         f->setDistance(d);
 
         files_left--;
@@ -874,6 +953,8 @@ void RDirNode::updateFilePositions() {
                 max_files = files_left;
             }
 
+            if(max_files > 0) ring = &getRingLayout(max_files);
+
             file_no=0;
         }
     }
@@ -885,6 +966,8 @@ void RDirNode::calcEdges() {
         spline.update(parent->getProjectedPos(), parent->getColour(), projected_pos, col, projected_spos);
     }
 
+    if(isCollapsed()) return;
+
     for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
         RDirNode* child = *it;
 
@@ -903,12 +986,7 @@ void RDirNode::logic(float dt) {
         node_normal = normalise(pos - parent->getPos());
     }
 
-    //update files
-     for(std::list<RFile*>::iterator it = files.begin(); it!=files.end(); it++) {
-         RFile* f = *it;
-
-         f->logic(dt);
-     }
+    //NOTE: files are updated separately by RFile::updateFiles() as most are asleep
 
     //update child nodes
     for(std::list<RDirNode*>::iterator it = children.begin(); it != children.end(); it++) {
@@ -959,6 +1037,8 @@ void RDirNode::calcScreenPos(GLint* viewport, GLdouble* modelview, GLdouble* pro
     static vec2 selected_offset(5.5f, -2.0f);
     static vec2 unselected_offset(5.5f, -1.0f);
 
+    if(isCollapsed()) return;
+
     if(!gGourceSettings.hide_filenames) {
 
         //first pass - calculate positions of names
@@ -976,11 +1056,14 @@ void RDirNode::calcScreenPos(GLint* viewport, GLdouble* modelview, GLdouble* pro
 
 void RDirNode::drawNames(FXFont& dirfont) {
 
+    //inside a collapsed directory
+    if(lod_parent_alpha <= 0.0f) return;
+
     if(!gGourceSettings.hide_dirnames && isVisible()) {
         drawDirName(dirfont);
     }
 
-    if(!gGourceSettings.hide_filenames) {
+    if(!gGourceSettings.hide_filenames && lod_alpha >= 1.0f) {
 
         if(!(gGourceSettings.hide_filenames || gGourceSettings.hide_files) && in_frustum) {
             for(std::list<RFile*>::const_iterator it = files.begin(); it!=files.end(); it++) {
@@ -1001,6 +1084,8 @@ void RDirNode::checkFrustum(const Frustum& frustum) {
 
     in_frustum = frustum.intersects(quadItemBounds);
 
+    if(isCollapsed()) return;
+
     for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
         RDirNode* node = (*it);
         node->checkFrustum(frustum);
@@ -1009,6 +1094,15 @@ void RDirNode::checkFrustum(const Frustum& frustum) {
 
 void RDirNode::drawShadows(float dt) const{
 
+    if(in_frustum && lod_expand < 1.0f && lod_parent_alpha > 0.0f && total_file_count > 0) {
+        glPushMatrix();
+            glTranslatef(2.0f, 2.0f, 0.0f);
+            drawCollapsed(vec4(0.0f, 0.0f, 0.0f, lod_parent_alpha * (1.0f - lod_expand) * 0.5f));
+        glPopMatrix();
+    }
+
+    if(isCollapsed()) return;
+
     if(in_frustum) {
 
         glPushMatrix();
@@ -1031,7 +1125,17 @@ void RDirNode::drawShadows(float dt) const{
     }
 }
 
-void RDirNode::updateFilesVBO(quadbuf& buffer, float dt) const{
+void RDirNode::updateFilesVBO(spritebuf& buffer, float dt) const{
+
+    //single node standing in for the collapsed directory
+    if(in_frustum && lod_expand < 1.0f && lod_parent_alpha > 0.0f && total_file_count > 0) {
+        vec3 avg = averageFileColour();
+        vec2 dims(dir_radius, dir_radius);
+
+        buffer.add(gGourceSettings.file_graphic->textureid, pos - dims*0.5f, dims, vec4(avg.x, avg.y, avg.z, lod_parent_alpha * (1.0f - lod_expand)));
+    }
+
+    if(isCollapsed()) return;
 
     if(in_frustum) {
 
@@ -1041,7 +1145,7 @@ void RDirNode::updateFilesVBO(quadbuf& buffer, float dt) const{
             if(f->isHidden()) continue;
 
             vec3 col   = f->getColour();
-            float alpha = f->getAlpha();
+            float alpha = f->getAlpha() * lod_alpha;
 
             buffer.add(f->graphic->textureid, f->getAbsolutePos() - f->dims*0.5f, f->dims, vec4(col.x, col.y, col.z, alpha));
         }
@@ -1055,13 +1159,16 @@ void RDirNode::updateFilesVBO(quadbuf& buffer, float dt) const{
 
 void RDirNode::updateBloomVBO(bloombuf& buffer, float dt) {
 
+    //inside a collapsed directory
+    if(lod_parent_alpha <= 0.0f) return;
+
     if(in_frustum && isVisible()) {
 
         float bloom_radius   = dir_radius * 2.0 * gGourceSettings.bloom_multiplier;
         float bloom_diameter = bloom_radius * 2.0;
         vec4 bloom_col      = col * gGourceSettings.bloom_intensity;
 
-        vec4 bloom_texcoords(bloom_radius, pos.x, pos.y, 0.0f);
+        vec3 bloom_texcoords(bloom_radius, pos.x, pos.y);
 
         vec2 bloom_dims(bloom_diameter, bloom_diameter);
 
@@ -1076,6 +1183,14 @@ void RDirNode::updateBloomVBO(bloombuf& buffer, float dt) {
 
 void RDirNode::drawFiles(float dt) const{
 
+    if(in_frustum && lod_expand < 1.0f && lod_parent_alpha > 0.0f && total_file_count > 0) {
+        vec3 avg = averageFileColour();
+
+        drawCollapsed(vec4(avg.x, avg.y, avg.z, lod_parent_alpha * (1.0f - lod_expand)));
+    }
+
+    if(isCollapsed()) return;
+
     if(in_frustum) {
         glPushMatrix();
             glTranslatef(pos.x, pos.y, 0.0);
@@ -1110,6 +1225,8 @@ void RDirNode::updateEdgeVBO(quadbuf& buffer) const {
 
     if(parent!=0 && (!gGourceSettings.hide_root || parent->parent !=0)) spline.drawToVBO(buffer);
 
+    if(isCollapsed()) return;
+
     for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
         RDirNode* child = (*it);
 
@@ -1123,6 +1240,8 @@ void RDirNode::drawEdgeShadows() const{
 
     if(parent!=0 && (!gGourceSettings.hide_root || parent->parent !=0)) spline.drawShadow();
 
+    if(isCollapsed()) return;
+
     for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
         RDirNode* child = (*it);
 
@@ -1137,6 +1256,8 @@ void RDirNode::drawEdges() const{
 
    if(parent!=0 && (!gGourceSettings.hide_root || parent->parent !=0)) spline.draw();
 
+    if(isCollapsed()) return;
+
     for(std::list<RDirNode*>::const_iterator it = children.begin(); it != children.end(); it++) {
         RDirNode* child = (*it);
 
@@ -1149,6 +1270,9 @@ void RDirNode::drawEdges() const{
 
 void RDirNode::drawBloom(float dt){
 
+    //inside a collapsed directory
+    if(lod_parent_alpha <= 0.0f) return;
+
     if(in_frustum && isVisible()) {
 
         float bloom_radius = dir_radius * 2.0 * gGourceSettings.bloom_multiplier;
@@ -1179,6 +1303,33 @@ void RDirNode::drawBloom(float dt){
     }
 }
 
+void RDirNode::drawCollapsed(const vec4& colour) const{
+
+    float halfsize = dir_radius * 0.5f;
+
+    glBindTexture(GL_TEXTURE_2D, gGourceSettings.file_graphic->textureid);
+
+    glColor4f(colour.x, colour.y, colour.z, colour.w);
+
+    glPushMatrix();
+        glTranslatef(pos.x, pos.y, 0.0);
+
+        glBegin(GL_QUADS);
+            glTexCoord2f(0.0f,0.0f);
+            glVertex2f(-halfsize, -halfsize);
+
+            glTexCoord2f(1.0f,0.0f);
+            glVertex2f(halfsize, -halfsize);
+
+            glTexCoord2f(1.0f,1.0f);
+            glVertex2f(halfsize, halfsize);
+
+            glTexCoord2f(0.0f,1.0f);
+            glVertex2f(-halfsize, halfsize);
+        glEnd();
+    glPopMatrix();
+}
+
 void RDirNode::updateQuadItemBounds() {
     float radius = getRadius();
 
@@ -29,9 +29,13 @@
 #include "spline.h"
 #include "file.h"
 #include "bloom.h"
+#include "sprites.h"
+#include "pathtrie.h"
+#include "pool.h"
 
 #include <list>
 #include <set>
+#include <vector>
 
 class RFile;
 
@@ -76,6 +80,17 @@ class RDirNode : public QuadItem {
     int depth;
 
     int visible_count;
+    int layout_count;
+
+    bool aggregates_dirty;
+    int total_file_count;
+    int total_dir_count;
+    vec3 file_colour_sum;
+
+    //level of detail
+    float lod_expand;
+    float lod_alpha;
+    float lod_parent_alpha;
 
     vec3 screenpos;
     vec2 node_normal;
@@ -83,6 +98,11 @@ class RDirNode : public QuadItem {
     void calcRadius();
     void calcColour();
 
+    void setVisible();
+
+    void updateDetail(float pixels_per_unit, float parent_alpha, float dt);
+    void drawCollapsed(const vec4& colour) const;
+
     std::string commonPathPrefix(const std::string& str) const;
 
     void changePath(const std::string & abspath);
@@ -93,7 +113,8 @@ class RDirNode : public QuadItem {
     void updateSplinePoint(float dt);
     void move(float dt);
 
-    vec2 calcFileDest(int layer_no, int file_no);
+    static vec2 calcFileDest(int max_files, int file_no);
+    static const std::vector<vec2>& getRingLayout(int max_files);
     void updateFilePositions();
 
     void adjustDepth();
@@ -103,6 +124,9 @@ public:
     RDirNode(RDirNode* parent, const std::string & abspath);
     ~RDirNode();
 
+    static void* operator new(size_t size);
+    static void operator delete(void* node);
+
     void printFiles();
 
     bool empty() const;
@@ -114,9 +138,15 @@ public:
     void fileUpdated(bool userInitiated);
     void nodeUpdated(bool userInitiated);
 
+    void markDirty();
+    void updateAggregates();
+
     void addVisible();
     bool isVisible();
 
+    void updateDetail(float pixels_per_unit, float dt);
+    bool isCollapsed() const;
+
     float getArea() const;
 
     int totalDirCount() const;
@@ -139,6 +169,7 @@ public:
     bool isParent(RDirNode* node) const;
 
     bool addFile(RFile* f);
+    void addFiles(std::vector<RFile*>::const_iterator begin, std::vector<RFile*>::const_iterator end);
     bool removeFile(RFile* f);
 
     int getDepth() const;
@@ -160,9 +191,6 @@ public:
 
     RDirNode* getParent() const;
 
-    bool isDir(const std::string& path) const;
-    void findDirs(const std::string& path, std::list<RDirNode*>& dirs);
-
     const vec2 & getPos() const;
 
     void calcEdges();
@@ -171,6 +199,7 @@ public:
     const vec2 & getSPos() const;
 
     void setPos(const vec2 & pos);
+    void setInitialPos(const vec2 & pos);
 
     void rotate(float s, float c);
     void rotate(float s, float c, const vec2& centre);
@@ -195,7 +224,7 @@ public:
 
     void checkFrustum(const Frustum & frustum);
 
-    void updateFilesVBO(quadbuf& buffer, float dt) const;
+    void updateFilesVBO(spritebuf& buffer, float dt) const;
     void updateBloomVBO(bloombuf& buffer, float dt);
 
     void drawShadows(float dt) const;
@@ -252,6 +281,6 @@ extern bool  gGourceNodeDebug;
 extern bool  gGourceGravity;
 extern float gGourceForceGravity;
 
-extern std::map<std::string, RDirNode*> gGourceDirMap;
+extern RObjectPool gGourceDirNodePool;
 
 #endif
@@ -0,0 +1,601 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "exporter.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+
+extern "C" {
+
+    static int exporter_thread(void *exp) {
+
+        RFrameExporter *exporter = static_cast<RFrameExporter*> (exp);
+        exporter->writeFrames();
+
+        return 0;
+    }
+
+};
+
+//hash of the frame pixels used to find repeated frames
+static uint64_t hashFrame(const char* pixels, size_t size) {
+
+    const uint64_t prime = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t lanes[4] = { 1, 2, 3, 4 };
+
+    size_t i = 0;
+
+    for(; i + 32 <= size; i += 32) {
+        uint64_t words[4];
+        memcpy(words, pixels + i, 32);
+
+        for(int l = 0; l < 4; l++) {
+            lanes[l] = (lanes[l] ^ words[l]) * prime;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+
+    uint64_t hash = size;
+
+    for(int l = 0; l < 4; l++) {
+        hash = (hash ^ lanes[l]) * prime;
+        hash ^= hash >> 32;
+    }
+
+    for(; i < size; i++) {
+        hash = (hash ^ (unsigned char) pixels[i]) * prime;
+    }
+
+    return hash ^ (hash >> 29);
+}
+
+// RStreamWriter
+
+RStreamWriter::RStreamWriter(const std::string& filename) : filename(filename) {
+
+    if(filename == "-") {
+        output = &std::cout;
+    } else {
+        output = new std::ofstream(filename.c_str(), std::ios::out | std::ios::binary);
+
+        if(output->fail()) {
+            delete output;
+            throw PPMExporterException(this->filename);
+        }
+    }
+}
+
+RStreamWriter::~RStreamWriter() {
+    output->flush();
+
+    if(output != &std::cout) delete output;
+}
+
+void RStreamWriter::writeFrame(const std::vector<char>& encoded, int width, int height) {
+    output->write(&(encoded[0]), encoded.size());
+}
+
+// RPPMWriter
+
+RPPMWriter::RPPMWriter(const std::string& filename) : RStreamWriter(filename) {
+}
+
+void RPPMWriter::encodeFrame(const char* pixels, int width, int height, std::vector<char>& encoded) {
+
+    char ppmheader[256];
+    snprintf(ppmheader, 256, "P6\n# Generated by Gource\n%d %d\n255\n", width, height);
+
+    size_t header_size = strlen(ppmheader);
+    size_t rowstride   = width * 3;
+
+    encoded.resize(header_size + rowstride * height);
+
+    memcpy(&(encoded[0]), ppmheader, header_size);
+
+    //drop alpha and flip rows top to bottom
+    for(int y = 0; y < height; y++) {
+        const char* in = pixels + (size_t) (height - y - 1) * width * 4;
+        char* out      = &(encoded[header_size]) + (size_t) y * rowstride;
+
+        for(int x = 0; x < width; x++) {
+            out[0] = in[0];
+            out[1] = in[1];
+            out[2] = in[2];
+            out += 3;
+            in  += 4;
+        }
+    }
+}
+
+// RYUVWriter
+
+RYUVWriter::RYUVWriter(const std::string& filename, RYUVLayout layout, bool y4m, int framerate, bool stream_header)
+    : RStreamWriter(filename), layout(layout), y4m(y4m), framerate(framerate) {
+    header_written = !stream_header;
+}
+
+void RYUVWriter::encodeFrame(const char* pixels, int width, int height, std::vector<char>& encoded) {
+
+    const char* frameheader = y4m ? "FRAME\n" : "";
+
+    size_t header_size = strlen(frameheader);
+
+    encoded.resize(header_size + yuv420FrameSize(width, height));
+
+    memcpy(&(encoded[0]), frameheader, header_size);
+
+    rgbaToYUV420((const unsigned char*) pixels, width, height, layout, (unsigned char*) &(encoded[header_size]));
+}
+
+void RYUVWriter::writeFrame(const std::vector<char>& encoded, int width, int height) {
+
+    if(y4m && !header_written) {
+        char streamheader[256];
+        snprintf(streamheader, 256, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, framerate);
+
+        output->write(streamheader, strlen(streamheader));
+        header_written = true;
+    }
+
+    RStreamWriter::writeFrame(encoded, width, height);
+}
+
+RFrameExporter* createFrameExporter(const std::string& format, const std::string& filename, int framerate, const std::string& timecodes_filename, bool stream_header) {
+
+    RFrameWriter* writer = 0;
+
+    if(format == "y4m") {
+        writer = new RYUVWriter(filename, RYUV_I420, true, framerate, stream_header);
+    } else if(format == "i420") {
+        writer = new RYUVWriter(filename, RYUV_I420, false, framerate);
+    } else if(format == "nv12") {
+        writer = new RYUVWriter(filename, RYUV_NV12, false, framerate);
+    } else {
+        writer = new RPPMWriter(filename);
+    }
+
+    //leave a core for the main thread
+    int worker_count = std::max(1, std::min(4, SDL_GetCPUCount() - 1));
+
+    RFrameExporter* exporter = new RFrameExporter(writer, worker_count);
+
+    if(!timecodes_filename.empty()) {
+        std::ofstream* timecodes = new std::ofstream(timecodes_filename.c_str(), std::ios::out);
+
+        if(timecodes->fail()) {
+            delete timecodes;
+            delete exporter;
+
+            std::string error_filename = timecodes_filename;
+            throw PPMExporterException(error_filename);
+        }
+
+        exporter->setTimecodes(timecodes, framerate);
+    }
+
+    return exporter;
+}
+
+// RFrameExporter
+
+RFrameExporter::RFrameExporter(RFrameWriter* writer, int worker_count, int ring_size, int queue_size) : writer(writer) {
+
+    timecodes   = 0;
+    framerate   = 0;
+
+    width       = 0;
+    height      = 0;
+    frame_size  = 0;
+
+    initialized = false;
+    use_pbo     = false;
+    tiled       = false;
+    tile_frame  = 0;
+
+    pbos.resize(ring_size, 0);
+    pbo_next    = 0;
+    pbo_pending = 0;
+
+    //enough frames to keep every worker busy
+    queue_size = std::max(queue_size, worker_count * 2);
+
+    for(int i = 0; i < queue_size; i++) {
+        RExportFrame* frame = new RExportFrame();
+        frame->pixels   = 0;
+        frame->sequence = 0;
+        frame->hash     = 0;
+        frame->duplicate = false;
+
+        frames.push_back(frame);
+    }
+
+    stopping = false;
+
+    frames_captured  = 0;
+    frames_hashed    = 0;
+    frames_written   = 0;
+    frames_dropped   = 0;
+    last_dropped     = -1;
+    duplicate_frames = 0;
+
+    last_hash = 0;
+
+    start_ticks   = 0;
+    capture_ticks = 0;
+    stall_ticks   = 0;
+    encode_ticks  = 0;
+    write_ticks   = 0;
+
+    mutex         = SDL_CreateMutex();
+    frame_queued  = SDL_CreateCond();
+    frame_freed   = SDL_CreateCond();
+    frame_hashed  = SDL_CreateCond();
+    frame_written = SDL_CreateCond();
+
+    for(int i = 0; i < worker_count; i++) {
+#if SDL_VERSION_ATLEAST(2,0,0)
+        threads.push_back(SDL_CreateThread( exporter_thread, "exporter", this ));
+#else
+        threads.push_back(SDL_CreateThread( exporter_thread, this ));
+#endif
+    }
+}
+
+RFrameExporter::~RFrameExporter() {
+
+    stop();
+
+    if(use_pbo) glDeleteBuffersARB(pbos.size(), &(pbos[0]));
+
+    for(std::vector<RExportFrame*>::iterator it = frames.begin(); it != frames.end(); it++) {
+        delete[] (*it)->pixels;
+        delete (*it);
+    }
+
+    SDL_DestroyCond(frame_written);
+    SDL_DestroyCond(frame_hashed);
+    SDL_DestroyCond(frame_freed);
+    SDL_DestroyCond(frame_queued);
+    SDL_DestroyMutex(mutex);
+
+    delete writer;
+
+    if(timecodes != 0) delete timecodes;
+}
+
+void RFrameExporter::setTimecodes(std::ostream* timecodes, int framerate) {
+    this->timecodes = timecodes;
+    this->framerate = framerate;
+
+    *timecodes << "# timecode format v2\n";
+}
+
+void RFrameExporter::writeTimecode(int sequence) {
+    char timecode[64];
+    snprintf(timecode, 64, "%.3f\n", sequence * 1000.0 / framerate);
+
+    *timecodes << timecode;
+}
+
+void RFrameExporter::init() {
+
+    width  = display.width;
+    height = display.height;
+
+    frame_size = (size_t) width * height * 4;
+
+    //tiled frames can be very large, keep only one per worker plus the one being drawn
+    if(tiled) {
+        size_t frame_count = std::max((size_t) 2, threads.size() + 1);
+
+        while(frames.size() > frame_count) {
+            delete frames.back();
+            frames.pop_back();
+        }
+    }
+
+    for(std::vector<RExportFrame*>::iterator it = frames.begin(); it != frames.end(); it++) {
+        (*it)->pixels = new char[frame_size];
+        free_frames.push_back(*it);
+    }
+
+    //tiles are read straight into the frame
+    use_pbo = GLEW_ARB_pixel_buffer_object && !tiled;
+
+    if(use_pbo) {
+        glGenBuffersARB(pbos.size(), &(pbos[0]));
+
+        for(size_t i = 0; i < pbos.size(); i++) {
+            glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pbos[i]);
+            glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, frame_size, 0, GL_STREAM_READ_ARB);
+        }
+
+        glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    }
+
+    start_ticks = SDL_GetPerformanceCounter();
+
+    initialized = true;
+}
+
+//wait for a worker to return a frame if they are all in use
+RExportFrame* RFrameExporter::acquireFrame() {
+
+    SDL_mutexP(mutex);
+
+    if(free_frames.empty()) {
+        Uint64 stall_start = SDL_GetPerformanceCounter();
+
+        while(free_frames.empty()) {
+            SDL_CondWait(frame_freed, mutex);
+        }
+
+        stall_ticks += SDL_GetPerformanceCounter() - stall_start;
+    }
+
+    RExportFrame* frame = free_frames.back();
+    free_frames.pop_back();
+
+    SDL_mutexV(mutex);
+
+    return frame;
+}
+
+void RFrameExporter::queueFrame(RExportFrame* frame) {
+
+    SDL_mutexP(mutex);
+
+    frame->sequence = frames_captured++;
+    queued_frames.push_back(frame);
+
+    SDL_CondSignal(frame_queued);
+
+    SDL_mutexV(mutex);
+}
+
+//copy the oldest completed read out of the ring
+void RFrameExporter::readPending() {
+
+    if(pbo_pending == 0) return;
+
+    size_t index = (pbo_next + pbos.size() - pbo_pending) % pbos.size();
+
+    RExportFrame* frame = acquireFrame();
+
+    glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pbos[index]);
+
+    void* pixels = glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+
+    if(pixels != 0) {
+        memcpy(frame->pixels, pixels, frame_size);
+        glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+    }
+
+    glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    pbo_pending--;
+
+    if(pixels != 0) {
+        queueFrame(frame);
+    } else {
+        SDL_mutexP(mutex);
+        free_frames.push_back(frame);
+        SDL_mutexV(mutex);
+    }
+}
+
+void RFrameExporter::dump() {
+
+    if(!initialized) init();
+
+    Uint64 capture_start = SDL_GetPerformanceCounter();
+
+    if(use_pbo) {
+
+        //reuse the oldest buffer in the ring once its read has been collected
+        if(pbo_pending == pbos.size()) readPending();
+
+        glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pbos[pbo_next]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+        pbo_next = (pbo_next + 1) % pbos.size();
+        pbo_pending++;
+
+    } else {
+        RExportFrame* frame = acquireFrame();
+
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, frame->pixels);
+
+        queueFrame(frame);
+    }
+
+    capture_ticks += SDL_GetPerformanceCounter() - capture_start;
+}
+
+void RFrameExporter::setTiled(bool tiled) {
+    this->tiled = tiled;
+}
+
+void RFrameExporter::beginFrame() {
+
+    if(!initialized) init();
+
+    tile_frame = acquireFrame();
+}
+
+//read a tile of the framebuffer into its place in the frame
+void RFrameExporter::dumpTile(int x, int y, int tile_width, int tile_height) {
+
+    if(tile_frame == 0) return;
+
+    Uint64 capture_start = SDL_GetPerformanceCounter();
+
+    glPixelStorei(GL_PACK_ROW_LENGTH, width);
+    glReadPixels(0, 0, tile_width, tile_height, GL_RGBA, GL_UNSIGNED_BYTE, tile_frame->pixels + ((size_t) y * width + x) * 4);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    capture_ticks += SDL_GetPerformanceCounter() - capture_start;
+}
+
+void RFrameExporter::endFrame() {
+
+    if(tile_frame == 0) return;
+
+    queueFrame(tile_frame);
+    tile_frame = 0;
+}
+
+void RFrameExporter::stop() {
+
+    if(threads.empty()) return;
+
+    if(initialized) {
+        while(pbo_pending > 0) readPending();
+    }
+
+    SDL_mutexP(mutex);
+    stopping = true;
+    SDL_CondBroadcast(frame_queued);
+    SDL_mutexV(mutex);
+
+    for(std::vector<SDL_Thread*>::iterator it = threads.begin(); it != threads.end(); it++) {
+        SDL_WaitThread(*it, 0);
+    }
+
+    //keep the duration of a trailing run of repeated frames
+    if(last_dropped >= 0 && last_dropped == frames_written - 1) {
+        writer->writeFrame(last_encoded, width, height);
+        writeTimecode(last_dropped);
+        frames_dropped--;
+    }
+
+    if(timecodes != 0) timecodes->flush();
+
+    if(frames_written > 0) {
+        double freq    = SDL_GetPerformanceFrequency();
+        double elapsed = (SDL_GetPerformanceCounter() - start_ticks) / freq;
+
+        debugLog("exporter: %d frames in %.2f s (%.2f fps) using %d worker threads", frames_written, elapsed, frames_written / elapsed, (int) threads.size());
+        debugLog("exporter: capture %.2f ms/frame (%.2f ms/frame waiting on workers), encode %.2f ms/frame, write %.2f ms/frame",
+            capture_ticks * 1000.0 / freq / frames_captured,
+            stall_ticks   * 1000.0 / freq / frames_captured,
+            encode_ticks  * 1000.0 / freq / frames_written,
+            write_ticks   * 1000.0 / freq / frames_written);
+        debugLog("exporter: %d repeated frames (%d dropped)", duplicate_frames, frames_dropped);
+    }
+
+    threads.clear();
+}
+
+void RFrameExporter::writeFrames() {
+
+    while(true) {
+
+        SDL_mutexP(mutex);
+
+        while(queued_frames.empty() && !stopping) {
+            SDL_CondWait(frame_queued, mutex);
+        }
+
+        if(queued_frames.empty()) {
+            SDL_mutexV(mutex);
+            break;
+        }
+
+        RExportFrame* frame = queued_frames.front();
+        queued_frames.pop_front();
+
+        SDL_mutexV(mutex);
+
+        Uint64 encode_start = SDL_GetPerformanceCounter();
+
+        frame->hash = hashFrame(frame->pixels, frame_size);
+
+        //compare with the previous frame
+        SDL_mutexP(mutex);
+
+        while(frame->sequence != frames_hashed) {
+            SDL_CondWait(frame_hashed, mutex);
+        }
+
+        frame->duplicate = frames_hashed > 0 && frame->hash == last_hash;
+
+        last_hash = frame->hash;
+        frames_hashed++;
+
+        SDL_CondBroadcast(frame_hashed);
+
+        SDL_mutexV(mutex);
+
+        if(!frame->duplicate) {
+            writer->encodeFrame(frame->pixels, width, height, frame->encoded);
+        }
+
+        Uint64 encode_end = SDL_GetPerformanceCounter();
+
+        //wait for earlier frames to be written
+        SDL_mutexP(mutex);
+
+        encode_ticks += encode_end - encode_start;
+
+        while(frame->sequence != frames_written) {
+            SDL_CondWait(frame_written, mutex);
+        }
+
+        SDL_mutexV(mutex);
+
+        Uint64 write_start = SDL_GetPerformanceCounter();
+
+        if(frame->duplicate) {
+            duplicate_frames++;
+
+            //leave a gap in the timecodes rather than writing the frame again
+            if(timecodes != 0) {
+                last_dropped = frame->sequence;
+                frames_dropped++;
+            } else {
+                writer->writeFrame(last_encoded, width, height);
+            }
+        } else {
+            writer->writeFrame(frame->encoded, width, height);
+
+            if(timecodes != 0) writeTimecode(frame->sequence);
+
+            //keep the encoded frame in case the next one repeats it
+            frame->encoded.swap(last_encoded);
+        }
+
+        Uint64 write_end = SDL_GetPerformanceCounter();
+
+        SDL_mutexP(mutex);
+
+        free_frames.push_back(frame);
+        frames_written++;
+        write_ticks += write_end - write_start;
+
+        SDL_CondBroadcast(frame_written);
+        SDL_CondSignal(frame_freed);
+
+        SDL_mutexV(mutex);
+    }
+}
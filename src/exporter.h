@@ -0,0 +1,176 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef REXPORTER_H
+#define REXPORTER_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <stdint.h>
+
+#include "SDL_thread.h"
+
+#include "core/display.h"
+#include "core/ppm.h"
+
+#include "yuv.h"
+
+// Writes frames read back from the framebuffer. Frames are RGBA with
+// rows ordered bottom to top, as returned by glReadPixels.
+
+class RFrameWriter {
+public:
+    virtual ~RFrameWriter() {};
+
+    // convert a frame to the output format. called from several threads at once.
+    virtual void encodeFrame(const char* pixels, int width, int height, std::vector<char>& encoded) = 0;
+
+    // write an encoded frame. called in frame order.
+    virtual void writeFrame(const std::vector<char>& encoded, int width, int height) = 0;
+};
+
+class RStreamWriter : public RFrameWriter {
+protected:
+    std::ostream* output;
+    std::string filename;
+public:
+    RStreamWriter(const std::string& filename);
+    ~RStreamWriter();
+
+    void writeFrame(const std::vector<char>& encoded, int width, int height);
+};
+
+class RPPMWriter : public RStreamWriter {
+public:
+    RPPMWriter(const std::string& filename);
+
+    void encodeFrame(const char* pixels, int width, int height, std::vector<char>& encoded);
+};
+
+// raw I420 / NV12 frames, or I420 in a yuv4mpegpipe stream. Without a
+// stream header the output continues a stream written elsewhere.
+class RYUVWriter : public RStreamWriter {
+    RYUVLayout layout;
+    bool y4m;
+    int framerate;
+    bool header_written;
+public:
+    RYUVWriter(const std::string& filename, RYUVLayout layout, bool y4m, int framerate, bool stream_header = true);
+
+    void encodeFrame(const char* pixels, int width, int height, std::vector<char>& encoded);
+    void writeFrame(const std::vector<char>& encoded, int width, int height);
+};
+
+// Asynchronous frame capture. Frames are read back into a ring of pixel
+// buffer objects so the read completes while the next frame is simulated
+// and drawn, then handed to worker threads through a bounded queue. The
+// workers encode frames in parallel and write them out in order.
+//
+// Tiled frames are assembled from several reads with beginFrame(),
+// dumpTile() and endFrame(). Tiles are read synchronously and fewer frames
+// are kept in flight, as each may be many times the size of the display.
+//
+// Frames identical to the previous frame are detected by hash and not
+// encoded again. With a timecodes file they are dropped from the stream
+// and the timestamps of the written frames are recorded instead.
+
+struct RExportFrame {
+    char* pixels;
+    std::vector<char> encoded;
+    int sequence;
+    uint64_t hash;
+    bool duplicate;
+};
+
+class RFrameExporter {
+    RFrameWriter* writer;
+
+    std::ostream* timecodes;
+    int framerate;
+
+    int width;
+    int height;
+    size_t frame_size;
+
+    bool initialized;
+    bool use_pbo;
+    bool tiled;
+
+    std::vector<GLuint> pbos;
+    size_t pbo_next;
+    size_t pbo_pending;
+
+    std::vector<RExportFrame*> frames;
+    std::vector<RExportFrame*> free_frames;
+    std::deque<RExportFrame*> queued_frames;
+
+    RExportFrame* tile_frame;
+
+    std::vector<SDL_Thread*> threads;
+    SDL_mutex* mutex;
+    SDL_cond* frame_queued;
+    SDL_cond* frame_freed;
+    SDL_cond* frame_hashed;
+    SDL_cond* frame_written;
+
+    bool stopping;
+
+    int frames_captured;
+    int frames_hashed;
+    int frames_written;
+    int frames_dropped;
+    int last_dropped;
+    int duplicate_frames;
+
+    uint64_t last_hash;
+    std::vector<char> last_encoded;
+
+    Uint64 start_ticks;
+    Uint64 capture_ticks;
+    Uint64 stall_ticks;
+    Uint64 encode_ticks;
+    Uint64 write_ticks;
+
+    void init();
+    RExportFrame* acquireFrame();
+    void queueFrame(RExportFrame* frame);
+    void readPending();
+    void writeTimecode(int sequence);
+public:
+    RFrameExporter(RFrameWriter* writer, int worker_count = 1, int ring_size = 3, int queue_size = 8);
+    ~RFrameExporter();
+
+    void setTimecodes(std::ostream* timecodes, int framerate);
+
+    void setTiled(bool tiled);
+
+    void dump();
+
+    void beginFrame();
+    void dumpTile(int x, int y, int tile_width, int tile_height);
+    void endFrame();
+
+    void stop();
+
+    void writeFrames();
+};
+
+RFrameExporter* createFrameExporter(const std::string& format, const std::string& filename, int framerate, const std::string& timecodes_filename = "", bool stream_header = true);
+
+#endif
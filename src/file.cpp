@@ -21,6 +21,13 @@ float gGourceFileDiameter  = 8.0;
 
 std::vector<RFile*> gGourceRemovedFiles;
 
+//files that need updating every frame. the rest are asleep until touched
+//or woken by a timer when they are due to start fading out
+std::vector<RFile*> gGourceActiveFiles;
+RTimerWheel gGourceFileTimers;
+
+RObjectPool gGourceFilePool(sizeof(RFile));
+
 FXFont file_selected_font;
 FXFont file_font;
 
@@ -44,21 +51,26 @@ RFile::RFile(const std::string & name, const vec3 & colour, const vec2 & pos, in
     expired        = false;
     forced_removal = false;
     removing       = false;
+    remove_pending = false;
 
     shadow = true;
 
     distance = 0;
 
+    active_index  = -1;
+    removed_index = -1;
+    clock_time    = gGourceFileTimers.getTime();
+
     setFilename(name);
 
-    if(!file_selected_font.initialized()) {
+    if(!file_selected_font.initialized() && !gGourceSettings.benchmark) {
         file_selected_font = fontmanager.grab(gGourceSettings.font_file, 18);
         file_selected_font.dropShadow(true);
         file_selected_font.roundCoordinates(false);
         file_selected_font.setColour(vec4(gGourceSettings.selection_colour, 1.0f));
     }
 
-    if(!file_font.initialized()) {
+    if(!file_font.initialized() && !gGourceSettings.benchmark) {
         file_font = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_filename_font_size);
         file_font.dropShadow(true);
         file_font.roundCoordinates(false);
@@ -68,12 +80,34 @@ RFile::RFile(const std::string & name, const vec3 & colour, const vec2 & pos, in
     setSelected(false);
 
     dir = 0;
+
+    wake();
 }
 
 RFile::~RFile() {
+    gGourceFileTimers.cancel(this);
+
+    if(active_index != -1) {
+        RFile* last = gGourceActiveFiles.back();
+        gGourceActiveFiles[active_index] = last;
+        last->active_index = active_index;
+        gGourceActiveFiles.pop_back();
+    }
+
+    cancelRemoval();
+}
+
+void* RFile::operator new(size_t size) {
+    return gGourceFilePool.allocate(size);
+}
+
+void RFile::operator delete(void* file) {
+    gGourceFilePool.release(file);
 }
 
 void RFile::remove(time_t removed_timestamp) {
+    wake();
+
     last_action = elapsed;
     fade_start  = elapsed;
     removing = true;
@@ -89,10 +123,123 @@ void RFile::setDir(RDirNode* dir) {
     this->dir = dir;
 }
 
+void RFile::setDest(const vec2 & dest) {
+    if(dest == this->dest) return;
+
+    wake();
+    this->dest = dest;
+}
+
+void RFile::setDistance(float distance) {
+    if(distance == this->distance) return;
+
+    wake();
+    this->distance = distance;
+}
+
+//update the files that are awake then advance the clock, waking any files that are due
+void RFile::updateFiles(float dt) {
+
+    gGourceFileTimers.advance(dt);
+
+    double now = gGourceFileTimers.getTime();
+
+    for(size_t i = 0; i < gGourceActiveFiles.size();) {
+        RFile* f = gGourceActiveFiles[i];
+
+        float file_dt = (float) (now - f->clock_time);
+        f->clock_time = now;
+
+        if(f->dir != 0 && f->dir->isCollapsed()) {
+            f->collapsedLogic(file_dt);
+        } else {
+            f->logic(file_dt);
+        }
+
+        //sleeping moves the last active file into this slot
+        if(f->canSleep()) {
+            f->sleep();
+        } else {
+            i++;
+        }
+    }
+}
+
+void RFile::wake() {
+
+    //bring elapsed up to date with the time spent asleep. hidden files
+    //don't age until they are shown
+    if(!isHidden() || forced_removal) {
+        elapsed += (float) (gGourceFileTimers.getTime() - clock_time);
+    }
+
+    clock_time = gGourceFileTimers.getTime();
+
+    gGourceFileTimers.cancel(this);
+
+    if(active_index != -1) return;
+
+    active_index = gGourceActiveFiles.size();
+    gGourceActiveFiles.push_back(this);
+}
+
+void RFile::sleep() {
+
+    RFile* last = gGourceActiveFiles.back();
+    gGourceActiveFiles[active_index] = last;
+    last->active_index = active_index;
+    gGourceActiveFiles.pop_back();
+
+    active_index = -1;
+
+    //wake up again when due to start fading out
+    if(!isHidden() && fade_start < 0.0f && gGourceSettings.file_idle_time > 0.0f) {
+        gGourceFileTimers.schedule(this, gGourceSettings.file_idle_time - (elapsed - last_action));
+    }
+}
+
+//true if nothing about the file will change until it is next touched or its idle time is up
+bool RFile::canSleep() const {
+
+    //fading out
+    if(fade_start > 0.0f && !expired) return false;
+
+    if(isHidden()) return true;
+
+    //fading in, blending from the touch colour or showing its name
+    if(elapsed < fadetime || (elapsed - last_action) < 1.0f || name_interval > 0.0f) return false;
+
+    //idle time is already up
+    if(fade_start < 0.0f && gGourceSettings.file_idle_time > 0.0f && (elapsed - last_action) >= gGourceSettings.file_idle_time) return false;
+
+    //still moving into place
+    if(glm::length2(dest * distance - pos) > 0.01f) return false;
+
+    return true;
+}
+
+void RFile::timerExpired() {
+    wake();
+}
+
 RDirNode* RFile::getDir() const{
     return dir;
 }
 
+std::list<RAction*>::iterator RFile::addAction(RAction* action) {
+    remove_pending = false;
+    return actions.insert(actions.end(), action);
+}
+
+void RFile::removeAction(std::list<RAction*>::iterator it) {
+    if(it == --actions.end()) remove_pending = false;
+    actions.erase(it);
+}
+
+const std::list<RAction*>& RFile::getActions() const{
+    return actions;
+}
+
 vec2 RFile::getAbsolutePos() const{
     return pos + dir->getPos();
 }
@@ -135,6 +282,7 @@ void RFile::setFilename(const std::string& abs_file_path) {
 
 void RFile::colourize() {
     file_colour = ext.size() ? colourHash(ext) : vec3(1.0f, 1.0f, 1.0f);
+    if(dir != 0) dir->markDirty();
 }
 
 const vec3& RFile::getNameColour() const{
@@ -143,6 +291,7 @@ const vec3& RFile::getNameColour() const{
 
 void RFile::setFileColour(const vec3 & colour) {
     file_colour = colour;
+    if(dir != 0) dir->markDirty();
 }
 
 const vec3 & RFile::getFileColour() const{
@@ -198,6 +347,22 @@ void RFile::logic(float dt) {
     //files have no momentum
     accel = vec2(0.0f, 0.0f);
 
+    updateExpiry();
+}
+
+//file is not being drawn as its directory is collapsed, so only keep track of
+//its age so it still fades out and expires on time
+void RFile::collapsedLogic(float dt) {
+    Pawn::logic(dt);
+
+    //no need to animate moving into place while out of sight
+    pos = dest * distance;
+
+    updateExpiry();
+}
+
+void RFile::updateExpiry() {
+
     if(fade_start < 0.0f && gGourceSettings.file_idle_time > 0.0f && (elapsed - last_action) > gGourceSettings.file_idle_time) {
         fade_start = elapsed;
     }
@@ -207,15 +372,8 @@ void RFile::logic(float dt) {
 
         expired = true;
 
-        bool found = false;
-        for(std::vector<RFile*>::iterator it = gGourceRemovedFiles.begin(); it != gGourceRemovedFiles.end(); it++) {
-            if((*it) == this) {
-                found = true;
-                break;
-            }
-        }
-
-        if(!found) {
+        if(removed_index == -1) {
+            removed_index = gGourceRemovedFiles.size();
             gGourceRemovedFiles.push_back(this);
             //fprintf(stderr, "expiring %s\n", fullpath.c_str());
         }
@@ -224,11 +382,25 @@ void RFile::logic(float dt) {
     if(isHidden() && !forced_removal) elapsed = 0.0;
 }
 
+//moves the last removed file into this slot
+void RFile::cancelRemoval() {
+    if(removed_index == -1) return;
+
+    RFile* last = gGourceRemovedFiles.back();
+    gGourceRemovedFiles[removed_index] = last;
+    last->removed_index = removed_index;
+    gGourceRemovedFiles.pop_back();
+
+    removed_index = -1;
+}
+
 void RFile::touch(time_t touched_timestamp, const vec3 & colour) {
     if(forced_removal || (removing && touched_timestamp < removed_timestamp)) return;
 
     //fprintf(stderr, "touch %s\n", fullpath.c_str());
 
+    wake();
+
     fade_start = -1.0f;
     removing = false;
     removed_timestamp = 0;
@@ -237,12 +409,7 @@ void RFile::touch(time_t touched_timestamp, const vec3 & colour) {
 
     //un expire file if touched after being removed
     if(expired) {
-        for(std::vector<RFile*>::iterator it = gGourceRemovedFiles.begin(); it != gGourceRemovedFiles.end(); it++) {
-            if((*it) == this) {
-                gGourceRemovedFiles.erase(it);
-                break;
-            }
-        }
+        cancelRemoval();
         expired=false;
     }
 
@@ -251,9 +418,24 @@ void RFile::touch(time_t touched_timestamp, const vec3 & colour) {
     dir->fileUpdated(true);
 }
 
+//show the file straight away without a user touching it, eg when restoring a checkpoint
+void RFile::restore(const vec3& colour) {
+    wake();
+
+    removing     = false;
+    removed_timestamp = 0;
+    fade_start   = -1.0f;
+    last_action  = elapsed;
+    touch_colour = colour;
+
+    setFileColour(colour);
+    setHidden(false);
+}
+
 void RFile::setHidden(bool hidden) {
-    if(this->hidden==true && hidden==false && dir !=0) {
-        dir->addVisible();
+    if(this->hidden==true && hidden==false) {
+        wake();
+        if(dir !=0) dir->addVisible();
     }
 
     Pawn::setHidden(hidden);
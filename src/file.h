@@ -21,10 +21,13 @@
 #include "pawn.h"
 #include "dirnode.h"
 #include "core/stringhash.h"
+#include "pool.h"
+#include "timerwheel.h"
 
 class RDirNode;
+class RAction;
 
-class RFile : public Pawn {
+class RFile : public Pawn, public RTimer {
     vec3 file_colour;
     vec3 touch_colour;
 
@@ -35,6 +38,9 @@ class RFile : public Pawn {
     bool expired;
     bool removing;
 
+    //the last action queued on the file is a remove
+    bool remove_pending;
+
     float fade_start;
     
     float last_action;
@@ -44,12 +50,32 @@ class RFile : public Pawn {
     vec2 dest;
     float distance;
 
+    std::list<RAction*> actions;
+
+    std::list<RFile*>::iterator recent_position;
+
+    //index in gGourceActiveFiles or -1 if asleep
+    int active_index;
+
+    //index in gGourceRemovedFiles or -1 if not expired
+    int removed_index;
+
+    //file clock time elapsed was last brought up to
+    double clock_time;
+
    // FXLabel* label;
 
     //GLuint namelist;
 
     void setFilename(const std::string& abs_file_path);
 
+    void updateExpiry();
+
+    void sleep();
+    bool canSleep() const;
+
+    void timerExpired();
+
     const vec3& getNameColour() const;
     void drawNameText(float alpha);
 public:
@@ -60,6 +86,9 @@ public:
     RFile(const std::string & name, const vec3 & colour, const vec2 & pos, int tagid);
     ~RFile();
 
+    static void* operator new(size_t size);
+    static void operator delete(void* file);
+
     bool overlaps(const vec2& pos) const;
 
     void setFileColour(const vec3 & colour);
@@ -69,29 +98,55 @@ public:
 
     float getAlpha() const;
 
+    void wake();
+
     void touch(time_t touch_timestamp, const vec3& colour);
+    void restore(const vec3& colour);
+
+    bool isRemoving() const { return removing; };
+
+    void setRemovePending() { remove_pending = true; };
+    bool isRemovePending() const { return remove_pending; };
 
     void setHidden(bool hidden);
 
-    void setDest(const vec2 & dest){ this->dest = dest; }
-    void setDistance(float distance){ this->distance = distance; }
+    void setDest(const vec2 & dest);
+    void setDistance(float distance);
 
     void calcScreenPos(GLint* viewport, GLdouble* modelview, GLdouble* projection);
 
+    static void updateFiles(float dt);
+
     void logic(float dt);
+    void collapsedLogic(float dt);
     void draw(float dt);
 
     void remove(time_t removed_timestamp);
     void remove();
 
+    //take the file off gGourceRemovedFiles
+    void cancelRemoval();
+
     vec2 getAbsolutePos() const;
 
     RDirNode* getDir() const;
     void setDir(RDirNode* dir);
+
+    std::list<RAction*>::iterator addAction(RAction* action);
+    void removeAction(std::list<RAction*>::iterator it);
+    const std::list<RAction*>& getActions() const;
+
+    void setRecentPosition(std::list<RFile*>::iterator it) { recent_position = it; };
+    std::list<RFile*>::iterator getRecentPosition() const { return recent_position; };
 };
 
 extern float gGourceFileDiameter;
 
 extern std::vector<RFile*> gGourceRemovedFiles;
 
+extern std::vector<RFile*> gGourceActiveFiles;
+extern RTimerWheel gGourceFileTimers;
+
+extern RObjectPool gGourceFilePool;
+
 #endif
@@ -188,6 +188,24 @@ void RCommitLog::seekTo(float percent) {
     ((SeekLog*)logf)->seekTo(percent);
 }
 
+//save the exact position of the next commit so it can be returned to later
+bool RCommitLog::getPosition(RCommitLogPosition& position) {
+    if(!seekable || buffered) return false;
+
+    position.pointer  = ((SeekLog*)logf)->getPointer();
+    position.lastline = lastline;
+
+    return true;
+}
+
+void RCommitLog::setPosition(const RCommitLogPosition& position) {
+    if(!seekable) return;
+
+    ((SeekLog*)logf)->setPointer(position.pointer);
+    lastline = position.lastline;
+    buffered = false;
+}
+
 float RCommitLog::getPercent() {
     if(seekable) return ((SeekLog*)logf)->getPercent();
 
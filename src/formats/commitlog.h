@@ -58,6 +58,16 @@ public:
     virtual bool parse(BaseLog* logf) { return false; };
 };
 
+// position in a seekable log including any line read ahead by the parser
+
+class RCommitLogPosition {
+public:
+    long pointer;
+    std::string lastline;
+
+    RCommitLogPosition() : pointer(-1) {};
+};
+
 class RCommitLog {
 protected:
     BaseLog* logf;
@@ -90,6 +100,9 @@ public:
 
     void seekTo(float percent);
 
+    bool getPosition(RCommitLogPosition& position);
+    void setPosition(const RCommitLogPosition& position);
+
     bool checkFormat();
 
     std::string getLogCommand();
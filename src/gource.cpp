@@ -24,7 +24,31 @@ int   gGourceMaxQuadTreeDepth = 6;
 
 int gGourceUserInnerLoops = 0;
 
-Gource::Gource(FrameExporter* exporter) {
+//fraction of the log between checkpoints
+float gGourceCheckpointInterval = 0.05f;
+
+//max number of files and dirs added to a checkpoint per frame
+size_t gGourceCheckpointBudget = 20000;
+
+//layout iterations run after catching up to the start position
+int gGourceCatchUpLayoutSteps = 300;
+
+//max number of files of commits processed per frame. the rest of a
+//large commit is carried over to the following frames
+size_t gGourceCommitFileBudget = 5000;
+
+//min number of new files in a commit to add them to the tree in bulk
+size_t gGourceBulkAddThreshold = 100;
+
+Gource::Gource(RFrameExporter* exporter) {
+
+    //repeatable runs: seed rand() and regenerate edges whenever their inputs
+    //change at all, so a frame doesn't depend on which frames were drawn before it
+    if(gGourceSettings.deterministic) {
+        srand(gGourceSettings.random_seed);
+        gGourceSplinePosEpsilon    = 0.0f;
+        gGourceSplineColourEpsilon = 0.0f;
+    }
 
     this->logfile = gGourceSettings.path;
     commitlog = 0;
@@ -32,79 +56,105 @@ Gource::Gource(FrameExporter* exporter) {
     //disable OpenGL 2.0 functions if not supported
     if(!GLEW_VERSION_2_0) gGourceSettings.ffp = true;
 
-    if(!gGourceSettings.file_graphic) {
+    if(!gGourceSettings.file_graphic && !gGourceSettings.benchmark) {
         gGourceSettings.file_graphic = texturemanager.grab("file.png", true, GL_CLAMP_TO_EDGE);
     }
 
+    //tiled output is scaled for the size of the whole frame
+    if(exporter != 0) gGourceFrameTiles.setGrid(gGourceSettings.output_tile_columns, gGourceSettings.output_tile_rows);
+
+    int output_width  = display.width  * gGourceFrameTiles.getColumns();
+    int output_height = display.height * gGourceFrameTiles.getRows();
+
     if(gGourceSettings.default_font_scale) {
         if(display.viewport_dpi_ratio.x > 1.0f) {
             gGourceSettings.font_scale = display.viewport_dpi_ratio.x;
         } else {
             int threshold = 1600;
-            gGourceSettings.font_scale = (float) (1 + glm::max(0, display.height / threshold));
+            gGourceSettings.font_scale = (float) (1 + glm::max(0, output_height / threshold));
         }
-        debugLog("setting font scale for resolution %d x %d to %.2f", display.width, display.height, gGourceSettings.font_scale);
+        debugLog("setting font scale for resolution %d x %d to %.2f", output_width, output_height, gGourceSettings.font_scale);
         gGourceSettings.setScaledFontSizes();
     }
 
-    fontlarge = fontmanager.grab(gGourceSettings.font_file, 42 * gGourceSettings.font_scale);
-    fontlarge.dropShadow(true);
-    fontlarge.roundCoordinates(true);
+    bloomtex = beamtex = usertex = logotex = backgroundtex = 0;
+    shadow_shader = text_shader = bloom_shader = 0;
+    sprite_shader = bloom_sprite_shader = 0;
+    font_texel_size = 1.0f / 512.0f;
 
-    fontmedium = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_font_size);
-    fontmedium.dropShadow(true);
-    fontmedium.roundCoordinates(false);
+    //no fonts, textures or shaders when running headless
+    if(!gGourceSettings.benchmark) {
 
-    fontcaption = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.caption_size);
-    fontcaption.dropShadow(true);
-    fontcaption.roundCoordinates(false);
-    fontcaption.alignTop(false);
+        fontlarge = fontmanager.grab(gGourceSettings.font_file, 42 * gGourceSettings.font_scale);
+        fontlarge.dropShadow(true);
+        fontlarge.roundCoordinates(true);
 
-    font = fontmanager.grab(gGourceSettings.font_file, 14 * gGourceSettings.font_scale);
-    font.dropShadow(true);
-    font.roundCoordinates(true);
+        fontmedium = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_font_size);
+        fontmedium.dropShadow(true);
+        fontmedium.roundCoordinates(false);
 
-    fontdirname = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_dirname_font_size);
-    fontdirname.dropShadow(true);
-    fontdirname.roundCoordinates(true);
+        fontcaption = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.caption_size);
+        fontcaption.dropShadow(true);
+        fontcaption.roundCoordinates(false);
+        fontcaption.alignTop(false);
 
-    slider.init();
+        font = fontmanager.grab(gGourceSettings.font_file, 14 * gGourceSettings.font_scale);
+        font.dropShadow(true);
+        font.roundCoordinates(true);
 
-    //only use bloom with alpha channel if transparent due to artifacts on some video cards
-    std::string bloom_tga = gGourceSettings.transparent ? "bloom_alpha.tga" : "bloom.tga";
+        fontdirname = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_dirname_font_size);
+        fontdirname.dropShadow(true);
+        fontdirname.roundCoordinates(true);
 
-    bloomtex = texturemanager.grab(bloom_tga);
-    beamtex  = texturemanager.grab("beam.png");
-    usertex  = texturemanager.grab("user.png", true, GL_CLAMP_TO_EDGE);
+        slider.init();
 
-    shadow_shader = text_shader = bloom_shader = 0;
+        //only use bloom with alpha channel if transparent due to artifacts on some video cards
+        std::string bloom_tga = gGourceSettings.transparent ? "bloom_alpha.tga" : "bloom.tga";
 
-    if(!gGourceSettings.ffp) {
-        shadow_shader      = shadermanager.grab("shadow");
-        bloom_shader       = shadermanager.grab("bloom");
-        text_shader        = shadermanager.grab("text");
-    }
+        bloomtex = texturemanager.grab(bloom_tga);
+        beamtex  = texturemanager.grab("beam.png");
+        usertex  = texturemanager.grab("user.png", true, GL_CLAMP_TO_EDGE);
 
-    //calculate once
-    GLint max_texture_size;
-    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
-    font_texel_size = 1.0f / (float) std::min( 512, max_texture_size );
+        if(!gGourceSettings.ffp) {
+            shadow_shader      = shadermanager.grab("shadow");
+            bloom_shader       = shadermanager.grab("bloom");
+            text_shader        = shadermanager.grab("text");
 
-    logotex = 0;
-    backgroundtex = 0;
+            if(RInstancedQuad::supported()) {
+                sprite_shader       = shadermanager.grab("sprite");
+                bloom_sprite_shader = shadermanager.grab("bloom_sprite");
+            }
+        }
 
-    //load logo
-    if(gGourceSettings.logo.size() > 0) {
-        bool mipmap_logo = !(GLEW_ARB_texture_non_power_of_two || GLEW_VERSION_2_0);
-        logotex = texturemanager.grabFile(gGourceSettings.logo, mipmap_logo);
-    }
+        bloom_vbo.setInstanced(bloom_sprite_shader != 0);
+
+        //without instancing write the sprites straight to the quad buffers
+        if(sprite_shader == 0) {
+            file_sprites.setQuads(&file_vbo);
+            user_sprites.setQuads(&user_vbo);
+        } else {
+            debugLog("drawing files and users as instanced sprites");
+        }
+
+        //calculate once
+        GLint max_texture_size;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+        font_texel_size = 1.0f / (float) std::min( 512, max_texture_size );
+
+        //load logo
+        if(gGourceSettings.logo.size() > 0) {
+            bool mipmap_logo = !(GLEW_ARB_texture_non_power_of_two || GLEW_VERSION_2_0);
+            logotex = texturemanager.grabFile(gGourceSettings.logo, mipmap_logo);
+        }
 
-    //load background image
-    if(gGourceSettings.background_image.size() > 0) {
-        backgroundtex = texturemanager.grabFile(gGourceSettings.background_image);
+        //load background image
+        if(gGourceSettings.background_image.size() > 0) {
+            backgroundtex = texturemanager.grabFile(gGourceSettings.background_image);
+        }
     }
 
     stop_position_reached=false;
+    catching_up=false;
 
     reloaded     = false;
     paused       = false;
@@ -117,7 +167,7 @@ Gource::Gource(FrameExporter* exporter) {
 
     take_screenshot = false;
 
-    if(gGourceSettings.hide_mouse) {
+    if(gGourceSettings.hide_mouse && !gGourceSettings.benchmark && !gGourceSettings.offscreen) {
         cursor.showCursor(false);
     }
 
@@ -128,6 +178,20 @@ Gource::Gource(FrameExporter* exporter) {
 
     frameExporter = 0;
 
+    file_upload_time   = 0.0f;
+    user_upload_time   = 0.0f;
+    action_upload_time = 0.0f;
+    edge_upload_time   = 0.0f;
+    bloom_upload_time  = 0.0f;
+    text_upload_time   = 0.0f;
+
+    dir_delete_started = false;
+
+    pending_checkpoint    = 0;
+    checkpoint_dir_index  = 0;
+    checkpoint_files_done = false;
+    checkpoint_layout     = false;
+
     dirNodeTree = 0;
     userTree = 0;
 
@@ -139,9 +203,11 @@ Gource::Gource(FrameExporter* exporter) {
     date_x_offset = 0;
     starting_z = -300.0f;
 
-    textbox = TextBox(fontmanager.grab(gGourceSettings.font_file, 18 * gGourceSettings.font_scale));
-    textbox.setBrightness(0.5f);
-    textbox.show();
+    if(!gGourceSettings.benchmark) {
+        textbox = TextBox(fontmanager.grab(gGourceSettings.font_file, 18 * gGourceSettings.font_scale));
+        textbox.setBrightness(0.5f);
+        textbox.show();
+    }
 
     file_key = FileKey(1.0f);
 
@@ -157,6 +223,15 @@ Gource::Gource(FrameExporter* exporter) {
     runtime = 0.0f;
     frameskip = 0;
     framecount = 0;
+    export_frame = 0;
+
+    processed_commits      = 0;
+    processed_commit_files = 0;
+
+    for(int i = 0; i < GOURCE_PHASE_COUNT; i++) {
+        phase_ticks[i] = 0;
+    }
+    phase_start = 0;
 
     reset();
 
@@ -216,6 +291,12 @@ void Gource::writeCustomLog(const std::string& logfile, const std::string& outpu
 Gource::~Gource() {
     reset();
 
+    for(std::vector<RCheckpoint*>::iterator it = checkpoints.begin(); it != checkpoints.end(); it++) {
+        delete (*it);
+    }
+    checkpoints.clear();
+    checkpoint_paths.clear();
+
     if(logmill!=0)   delete logmill;
     if(root!=0)      delete root;
 
@@ -233,6 +314,8 @@ void Gource::unload() {
     edge_vbo.unload();
     action_vbo.unload();
     bloom_vbo.unload();
+    file_sprites.unload();
+    user_sprites.unload();
 
 }
 
@@ -243,6 +326,11 @@ void Gource::reload() {
 void Gource::quit() {
 }
 
+//milliseconds since a performance counter reading
+static float elapsedMs(Uint64 start) {
+    return (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
 void Gource::update(float t, float dt) {
 
     float scaled_dt = std::min(dt, max_tick_rate);
@@ -255,23 +343,61 @@ void Gource::update(float t, float dt) {
     //apply time scaling
     scaled_dt *= gGourceSettings.time_scale;
 
-    //have to manage runtime internally as we're messing with dt
-    if(!paused) runtime += scaled_dt;
+    //a deterministic run always finishes loading the log on the same tick
+    if(gGourceSettings.deterministic && commitlog == 0) logmill->getLog();
 
-    if(gGourceSettings.stop_at_time > 0.0 && runtime >= gGourceSettings.stop_at_time) stop_position_reached = true;
+    //logic and drawing see the size of the whole frame when it is rendered in tiles
+    bool tiled = frameExporter != 0 && gGourceFrameTiles.enabled();
+
+    if(tiled) gGourceFrameTiles.begin();
 
     logic_time = SDL_GetTicks();
 
-    logic(runtime, scaled_dt);
+    //when exporting only the frames that are captured get drawn,
+    //the ticks skipped by frameskip just run the logic
+    if(frameExporter != 0 && commitlog) skipTicks(scaled_dt);
+
+    step(scaled_dt);
+
+    //frames before the start of --output-frame-range are simulated but not drawn
+    if(frameExporter != 0 && commitlog && export_frame < gGourceSettings.output_frame_start) {
+        export_frame++;
+
+        Uint32 skip_start = SDL_GetTicks();
+
+        //return periodically so events are still handled
+        while(export_frame < gGourceSettings.output_frame_start && !appFinished && !gGourceSettings.shutdown && SDL_GetTicks() - skip_start < 100) {
+            skipTicks(scaled_dt);
+            step(scaled_dt);
+            export_frame++;
+        }
+
+        logic_time = SDL_GetTicks() - logic_time;
+
+        if(tiled) gGourceFrameTiles.end();
+        return;
+    }
 
     logic_time = SDL_GetTicks() - logic_time;
 
-    draw(runtime, scaled_dt);
+    //every drawn frame is captured
+    bool capture = frameExporter != 0 && commitlog && !gGourceSettings.shutdown;
+
+    if(capture && tiled) {
+        drawTiles(runtime, scaled_dt);
+    } else {
+        draw(runtime, scaled_dt);
+
+        if(capture) frameExporter->dump();
+    }
 
-    //extract frames based on frameskip setting if frameExporter defined
-    if(frameExporter != 0 && commitlog && !gGourceSettings.shutdown) {
-        if(framecount % (frameskip+1) == 0) {
-            frameExporter->dump();
+    if(tiled) gGourceFrameTiles.end();
+
+    if(capture) {
+        export_frame++;
+
+        if(gGourceSettings.output_frame_end >= 0 && export_frame >= gGourceSettings.output_frame_end) {
+            appFinished = true;
         }
     }
 
@@ -284,6 +410,127 @@ void Gource::update(float t, float dt) {
     framecount++;
 }
 
+//draw the frame once per tile, assembling the tiles in the exported frame
+void Gource::drawTiles(float t, float dt) {
+
+    frameExporter->beginFrame();
+
+    for(int row = 0; row < gGourceFrameTiles.getRows(); row++) {
+        for(int column = 0; column < gGourceFrameTiles.getColumns(); column++) {
+
+            gGourceFrameTiles.setTile(column, row);
+
+            draw(t, dt);
+
+            frameExporter->dumpTile(gGourceFrameTiles.getTileX(), gGourceFrameTiles.getTileY(),
+                                    gGourceFrameTiles.getTileWidth(), gGourceFrameTiles.getTileHeight());
+        }
+    }
+
+    gGourceFrameTiles.clearTile();
+
+    frameExporter->endFrame();
+}
+
+//run the ticks between exported frames
+void Gource::skipTicks(float dt) {
+    for(int i = 0; i < frameskip && !appFinished && !gGourceSettings.shutdown; i++) {
+        step(dt);
+        framecount++;
+    }
+}
+
+//advance runtime and run the logic for one tick
+void Gource::step(float dt) {
+
+    //have to manage runtime internally as we're messing with dt
+    if(!paused) runtime += dt;
+
+    if(gGourceSettings.stop_at_time > 0.0 && runtime >= gGourceSettings.stop_at_time) stop_position_reached = true;
+
+    logic(runtime, dt);
+}
+
+//advance the simulation by a fixed time step without drawing anything
+void Gource::simulate(float dt) {
+
+    //wait for the log to be loaded
+    if(isLoading()) return;
+
+    float scaled_dt = dt * gGourceSettings.time_scale;
+
+    runtime += scaled_dt;
+
+    if(gGourceSettings.stop_at_time > 0.0 && runtime >= gGourceSettings.stop_at_time) stop_position_reached = true;
+
+    logic(runtime, scaled_dt);
+
+    framecount++;
+}
+
+bool Gource::isLoading() {
+    return commitlog == 0 && !logmill->isFinished();
+}
+
+size_t Gource::getFileCount() const {
+    return files.size();
+}
+
+size_t Gource::getUserCount() const {
+    return users.size();
+}
+
+size_t Gource::getDirCount() const {
+    return gGourceDirTrie.size();
+}
+
+size_t Gource::getCheckpointCount() const {
+    return checkpoints.size();
+}
+
+void Gource::getFilePaths(std::vector<std::string>& paths) const {
+    for(std::map<std::string,RFile*>::const_iterator it = files.begin(); it != files.end(); it++) {
+        RFile* file = it->second;
+
+        if(file->isRemoving() || file->isRemovePending()) continue;
+
+        paths.push_back(it->first);
+    }
+}
+
+int Gource::getProcessedCommits() const {
+    return processed_commits;
+}
+
+int Gource::getProcessedCommitFiles() const {
+    return processed_commit_files;
+}
+
+void Gource::endPhase(int phase) {
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    phase_ticks[phase] += now - phase_start;
+    phase_start = now;
+}
+
+double Gource::getPhaseSeconds(int phase) const {
+    return phase_ticks[phase] / (double) SDL_GetPerformanceFrequency();
+}
+
+const char* Gource::getPhaseName(int phase) {
+    switch(phase) {
+        case GOURCE_PHASE_READ_LOG:         return "read log";
+        case GOURCE_PHASE_PROCESS_COMMITS:  return "process commits";
+        case GOURCE_PHASE_UPDATE_BOUNDS:    return "update bounds";
+        case GOURCE_PHASE_INTERACT_USERS:   return "interact users";
+        case GOURCE_PHASE_UPDATE_USERS:     return "update users";
+        case GOURCE_PHASE_INTERACT_DIRS:    return "interact dirs";
+        case GOURCE_PHASE_UPDATE_DIRS:      return "update dirs";
+        case GOURCE_PHASE_UPDATE_CAMERA:    return "update camera";
+    }
+    return "";
+}
+
 //peek at the date under the mouse pointer on the slider
 std::string Gource::dateAtPosition(float percent) {
 
@@ -502,7 +749,7 @@ void Gource::showSplash() {
     splash = 15.0;
 }
 
-void Gource::setFrameExporter(FrameExporter* exporter, int video_framerate) {
+void Gource::setFrameExporter(RFrameExporter* exporter, int video_framerate) {
 
     int gource_framerate = video_framerate;
 
@@ -518,6 +765,8 @@ void Gource::setFrameExporter(FrameExporter* exporter, int video_framerate) {
 
     this->max_tick_rate = 1.0f / ((float) gource_framerate);
 
+    exporter->setTiled(gGourceFrameTiles.enabled());
+
     this->frameExporter = exporter;
 }
 
@@ -881,7 +1130,10 @@ void Gource::reset() {
     dir_bounds.reset();
     commitqueue.clear();
     tagusermap.clear();
-    gGourceRemovedFiles.clear();
+    dir_delete_paths.clear();
+    dir_delete_started = false;
+
+    discardCheckpoint();
 
     if(userTree!=0) delete userTree;
     if(dirNodeTree!=0) delete dirNodeTree;
@@ -924,13 +1176,14 @@ void Gource::reset() {
     root = new RDirNode(0, "/");
 
     //delete users
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it != users.end(); it++) {
-        delete it->second;
+    for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+        delete (*it);
     }
 
     users.clear();
+    user_names.clear();
 
-    //delete
+    //delete (files take themselves off gGourceRemovedFiles)
     for(std::map<std::string,RFile*>::iterator it = files.begin(); it != files.end(); it++) {
         delete it->second;
     }
@@ -944,6 +1197,7 @@ void Gource::reset() {
     }
 
     files.clear();
+    recent_files.clear();
     captions.clear();
     active_captions.clear();
 
@@ -972,33 +1226,57 @@ void Gource::deleteFile(RFile* file) {
         selectFile(0);
     }
 
-    //remove from any users with actions against this file - wrong way around? meh
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-        RUser* user = it->second;
-
-        user->fileRemoved(file);
+    //remove any user actions against this file
+    while(!file->getActions().empty()) {
+        RAction* action = file->getActions().front();
+        action->source->removeAction(action);
     }
 
     files.erase(file->fullpath);
     file_key.dec(file);
 
+    if(gGourceSettings.max_files_lru) recent_files.erase(file->getRecentPosition());
+
     //debugLog("removed file %s\n", file->fullpath.c_str());
 
     delete file;
 }
 
 
-RFile* Gource::addFile(const RCommitFile& cf) {
+//move a file to the front of the recently touched list
+void Gource::touchRecentFile(RFile* file) {
+    if(!gGourceSettings.max_files_lru) return;
 
-    //if we already have max files in circulation
-    //we cant add any more
-    if(gGourceSettings.max_files > 0 && files.size() >= gGourceSettings.max_files) return 0;
+    recent_files.splice(recent_files.begin(), recent_files, file->getRecentPosition());
+}
+
+//retire the least recently touched file to make room for a new one
+void Gource::evictFile() {
+
+    RFile* file = recent_files.back();
+
+    //deleting also takes it off gGourceRemovedFiles if it had expired
+    deleteFile(file);
+}
+
+//create a file without adding it to the tree
+RFile* Gource::createFile(const RCommitFile& cf) {
 
     //see if this is a directory
     std::string file_as_dir = cf.filename;
     if(file_as_dir[file_as_dir.size()-1] != '/') file_as_dir.append("/");
 
-    if(root->isDir(file_as_dir)) return 0;
+    if(gGourceDirTrie.isDir(file_as_dir)) return 0;
+
+    //if we already have max files in circulation
+    //we either make room or cant add any more
+    if(gGourceSettings.max_files > 0 && files.size() >= gGourceSettings.max_files) {
+        if(!gGourceSettings.max_files_lru) return 0;
+
+        while(!recent_files.empty() && files.size() >= gGourceSettings.max_files) {
+            evictFile();
+        }
+    }
 
     int tagid = tag_seq++;
 
@@ -1006,6 +1284,19 @@ RFile* Gource::addFile(const RCommitFile& cf) {
 
     files[cf.filename] = file;
 
+    if(gGourceSettings.max_files_lru) {
+        file->setRecentPosition(recent_files.insert(recent_files.begin(), file));
+    }
+
+    return file;
+}
+
+RFile* Gource::addFile(const RCommitFile& cf) {
+
+    RFile* file = createFile(cf);
+
+    if(!file) return 0;
+
     root->addFile(file);
 
     file_key.inc(file);
@@ -1018,6 +1309,102 @@ RFile* Gource::addFile(const RCommitFile& cf) {
     return file;
 }
 
+//order commit files by directory then name so files of the same directory are together
+static bool commit_file_dir_order(const RCommitFile* a, const RCommitFile* b) {
+
+    size_t a_slash = a->filename.rfind('/');
+    size_t b_slash = b->filename.rfind('/');
+
+    size_t a_dir = a_slash != std::string::npos ? a_slash+1 : 0;
+    size_t b_dir = b_slash != std::string::npos ? b_slash+1 : 0;
+
+    int c = a->filename.compare(0, a_dir, b->filename, 0, b_dir);
+
+    if(c != 0) return c < 0;
+
+    return a->filename.compare(b->filename) < 0;
+}
+
+//add the new files among the next max_files entries of a commit to the tree in one pass.
+//files are grouped by directory so each directory is found and laid out once.
+void Gource::addFiles(const RCommit& commit, size_t max_files) {
+
+    //the limit and eviction are handled a file at a time by addFile
+    if(gGourceSettings.max_files > 0) return;
+
+    std::vector<const RCommitFile*> new_files;
+
+    size_t n = 0;
+    for(std::list<RCommitFile>::const_iterator it = commit.files.begin(); it != commit.files.end() && n < max_files; it++, n++) {
+        const RCommitFile& cf = *it;
+
+        if(cf.filename.empty() || cf.filename[cf.filename.size()-1] == '/') continue;
+
+        if(files.find(cf.filename) != files.end()) continue;
+
+        new_files.push_back(&cf);
+    }
+
+    if(new_files.size() < gGourceBulkAddThreshold) return;
+
+    std::sort(new_files.begin(), new_files.end(), commit_file_dir_order);
+
+    //file key counts by extension
+    std::map<std::string, std::pair<RFile*, int> > key_counts;
+
+    std::vector<RFile*> group;
+
+    for(size_t i = 0; i < new_files.size(); i++) {
+        const RCommitFile& cf = *(new_files[i]);
+
+        //listed more than once
+        if(i > 0 && cf.filename == new_files[i-1]->filename) continue;
+
+        RFile* file = createFile(cf);
+
+        if(!file) continue;
+
+        std::map<std::string, std::pair<RFile*, int> >::iterator key = key_counts.find(file->ext);
+
+        if(key != key_counts.end()) {
+            key->second.second++;
+        } else {
+            key_counts[file->ext] = std::make_pair(file, 1);
+        }
+
+        if(!group.empty() && group.front()->path != file->path) {
+            addFileGroup(group);
+            group.clear();
+        }
+
+        group.push_back(file);
+    }
+
+    if(!group.empty()) addFileGroup(group);
+
+    for(std::map<std::string, std::pair<RFile*, int> >::iterator it = key_counts.begin(); it != key_counts.end(); it++) {
+        file_key.inc(it->second.first, it->second.second);
+    }
+}
+
+//add files from the same directory to the tree
+void Gource::addFileGroup(const std::vector<RFile*>& group) {
+
+    RFile* first = group.front();
+
+    //the first file creates the directory if needed
+    root->addFile(first);
+
+    while(root->getParent() != 0) {
+        debugLog("parent changed to %s", root->getPath().c_str());
+        root = root->getParent();
+    }
+
+    if(group.size() > 1) {
+        first->getDir()->addFiles(group.begin()+1, group.end());
+    }
+}
+
 RUser* Gource::addUser(const std::string& username) {
 
     vec2 pos;
@@ -1032,8 +1419,11 @@ RUser* Gource::addUser(const std::string& username) {
 
     RUser* user = new RUser(username, pos, tagid);
 
-    users[username]   = user;
-    tagusermap[tagid] = user;
+    user->setIndex(users.size());
+
+    users.push_back(user);
+    user_names[username] = user;
+    tagusermap[tagid]    = user;
 
     //debugLog("added user %s, tagid = %d\n", username.c_str(), tagid);
 
@@ -1050,7 +1440,13 @@ void Gource::deleteUser(RUser* user) {
         selectUser(0);
     }
 
-    users.erase(user->getName());
+    //swap the last user into the removed slot
+    RUser* last = users.back();
+    users[user->getIndex()] = last;
+    last->setIndex(user->getIndex());
+    users.pop_back();
+
+    user_names.erase(user->getName());
     tagusermap.erase(user->getTagID());
 
     //debugLog("deleted user %s, tagid = %d\n", user->getName().c_str(), user->getTagID());
@@ -1074,9 +1470,312 @@ void Gource::seekTo(float percent) {
 
     reset();
 
+    //restore the closest earlier checkpoint and quickly apply the commits since
+    RCheckpoint* checkpoint = findCheckpoint(percent);
+
+    if(checkpoint != 0) {
+        restoreCheckpoint(*checkpoint);
+        fastForward(percent);
+        return;
+    }
+
     commitlog->seekTo(percent);
 }
 
+//true if there isn't already a checkpoint near this position in the log
+bool Gource::needCheckpoint(float percent) {
+    if(pending_checkpoint != 0) return false;
+
+    for(std::vector<RCheckpoint*>::iterator it = checkpoints.begin(); it != checkpoints.end(); it++) {
+        if(fabs((*it)->percent - percent) < gGourceCheckpointInterval) return false;
+    }
+
+    return true;
+}
+
+//start a snapshot of the live files and directory positions at the position of the next commit.
+//the snapshot is filled in by updateCheckpoint, which may take several frames
+void Gource::beginCheckpoint(bool save_layout) {
+
+    discardCheckpoint();
+
+    RCheckpoint* checkpoint = new RCheckpoint();
+
+    if(!commitlog->getPosition(checkpoint->position)) {
+        delete checkpoint;
+        return;
+    }
+
+    checkpoint->percent = commitlog->getPercent();
+
+    checkpoint->files.reserve(files.size());
+
+    pending_checkpoint    = checkpoint;
+    checkpoint_cursor     = "";
+    checkpoint_dir_index  = 0;
+    checkpoint_files_done = false;
+    checkpoint_layout     = save_layout;
+}
+
+//add up to max_items files and dirs to the pending checkpoint, returns true when it is complete.
+//commits processed while the snapshot is in progress may have changed files that were
+//already added, so the checkpoint is only used for seeks past where it completes.
+//restoring replays every commit since it began, and as replaying a commit sets the state
+//of the files it touches, any files changed in the meantime end up as they should.
+bool Gource::updateCheckpoint(size_t max_items) {
+
+    if(pending_checkpoint == 0) return false;
+
+    RCheckpoint* checkpoint = pending_checkpoint;
+
+    size_t items = 0;
+
+    if(!checkpoint_files_done) {
+
+        std::map<std::string,RFile*>::iterator it = files.lower_bound(checkpoint_cursor);
+
+        for(; it != files.end() && items < max_items; it++, items++) {
+            RFile* file = it->second;
+
+            //skip files that are going or have a remove action still to be applied
+            if(file->isRemoving() || file->isRemovePending()) continue;
+
+            checkpoint->files.push_back(RCheckpointFile(checkpoint_paths.intern(file->fullpath), file->getFileColour()));
+        }
+
+        if(it != files.end()) {
+            checkpoint_cursor = it->first;
+            return false;
+        }
+
+        checkpoint_files_done = true;
+    }
+
+    //dirs added or removed since the start may be skipped, which only affects their initial position
+    if(checkpoint_layout) {
+
+        if(checkpoint_dir_index == 0) checkpoint->dirs.reserve(gGourceDirTrie.size());
+
+        for(; checkpoint_dir_index < gGourceDirTrie.size() && items < max_items; checkpoint_dir_index++, items++) {
+            RDirNode* dir = gGourceDirTrie.getDir(checkpoint_dir_index);
+
+            checkpoint->dirs.push_back(RCheckpointDir(checkpoint_paths.intern(dir->getPath()), dir->getPos()));
+        }
+
+        if(checkpoint_dir_index < gGourceDirTrie.size()) return false;
+    }
+
+    checkpoint->percent = std::max(checkpoint->percent, commitlog->getPercent());
+
+    pending_checkpoint = 0;
+
+    //keep sorted by position
+    std::vector<RCheckpoint*>::iterator it = checkpoints.begin();
+    while(it != checkpoints.end() && (*it)->percent < checkpoint->percent) it++;
+
+    checkpoints.insert(it, checkpoint);
+
+    debugLog("checkpoint at %.2f: %d files, %d dirs, %d paths", checkpoint->percent, (int) checkpoint->files.size(), (int) checkpoint->dirs.size(), (int) checkpoint_paths.size());
+
+    return true;
+}
+
+void Gource::discardCheckpoint() {
+    if(pending_checkpoint != 0) delete pending_checkpoint;
+    pending_checkpoint = 0;
+}
+
+//find the closest checkpoint at or before percent
+RCheckpoint* Gource::findCheckpoint(float percent) {
+
+    RCheckpoint* closest = 0;
+
+    for(std::vector<RCheckpoint*>::iterator it = checkpoints.begin(); it != checkpoints.end(); it++) {
+        if((*it)->percent > percent) break;
+        closest = *it;
+    }
+
+    return closest;
+}
+
+void Gource::restoreCheckpoint(const RCheckpoint& checkpoint) {
+
+    for(std::vector<RCheckpointFile>::const_iterator it = checkpoint.files.begin(); it != checkpoint.files.end(); it++) {
+        restoreFile(RCommitFile(checkpoint_paths.getPath(it->path), "A", it->colour));
+    }
+
+    for(std::vector<RCheckpointDir>::const_iterator it = checkpoint.dirs.begin(); it != checkpoint.dirs.end(); it++) {
+        RDirNode* dir = gGourceDirTrie.find(checkpoint_paths.getPath(it->path));
+
+        if(dir != 0 && dir->getParent() != 0) dir->setInitialPos(it->pos);
+    }
+
+    commitlog->setPosition(checkpoint.position);
+}
+
+//apply commits directly to the tree until percent is reached
+void Gource::fastForward(float percent) {
+
+    while(!commitlog->isFinished() && commitlog->getPercent() < percent) {
+
+        //checkpoint along the way so later seeks have less to do
+        if(needCheckpoint(commitlog->getPercent())) {
+            beginCheckpoint(false);
+            updateCheckpoint((size_t) -1);
+        }
+
+        RCommit commit;
+
+        if(!commitlog->nextCommit(commit)) continue;
+
+        if(gGourceSettings.stop_timestamp != 0 && commit.timestamp > gGourceSettings.stop_timestamp) {
+            //leave it to be read again by readLog
+            commitlog->bufferCommit(commit);
+            break;
+        }
+
+        applyCommit(commit);
+    }
+
+    updateFilePositions();
+}
+
+//apply the history before the start position or date to the tree
+void Gource::catchUp() {
+
+    if(gGourceSettings.start_position > 0.0f) {
+        if(commitlog->isSeekable()) fastForward(gGourceSettings.start_position);
+    } else if(!catchUpToDate()) {
+        //the stream hasn't reached the start date yet, carry on next frame
+        catching_up = true;
+        return;
+    }
+
+    catching_up = false;
+
+    settleLayout();
+}
+
+//apply commits before the start date, returns false if a stream has
+//no more to read yet
+bool Gource::catchUpToDate() {
+
+    RCommit commit;
+
+    while(!gGourceSettings.shutdown && !commitlog->isFinished()) {
+
+        //validated separately so a filtered commit is not taken for the end of the stream
+        if(!commitlog->nextCommit(commit, false)) {
+            if(!commitlog->isSeekable()) {
+                updateFilePositions();
+                return false;
+            }
+            continue;
+        }
+
+        if(!commit.isValid()) continue;
+
+        //leave the first commit after the start date to be read by readLog
+        if(commit.timestamp >= gGourceSettings.start_timestamp) {
+            commitlog->bufferCommit(commit);
+            break;
+        }
+
+        applyCommit(commit);
+    }
+
+    updateFilePositions();
+
+    return true;
+}
+
+//run the directory layout for a fixed number of steps so it has settled before the first frame
+void Gource::settleLayout() {
+
+    float dt = 1.0f / 60.0f;
+
+    for(int i = 0; i < gGourceCatchUpLayoutSteps; i++) {
+        updateBounds();
+        interactDirs();
+
+        root->applyForces(*dirNodeTree);
+        root->logic(dt);
+
+        RFile::updateFiles(dt);
+    }
+
+    updateBounds();
+}
+
+//add or update a file without a user action
+RFile* Gource::restoreFile(const RCommitFile& cf) {
+
+    RFile* file = 0;
+
+    std::map<std::string, RFile*>::iterator seen_file = files.find(cf.filename);
+    if(seen_file != files.end()) file = seen_file->second;
+
+    if(file == 0) {
+        file = addFile(cf);
+
+        if(!file) return 0;
+    }
+
+    file->restore(cf.colour);
+
+    touchRecentFile(file);
+
+    return file;
+}
+
+//apply the changes of a commit straight to the tree with no users or animation
+void Gource::applyCommit(const RCommit& commit) {
+
+    for(std::list<RCommitFile>::const_iterator it = commit.files.begin(); it != commit.files.end(); it++) {
+
+        const RCommitFile& cf = *it;
+
+        //deleting a directory
+        if(!cf.filename.empty() && cf.filename[cf.filename.size()-1] == '/') {
+
+            if(cf.action != "D") continue;
+
+            std::list<RDirNode*> dirs;
+
+            gGourceDirTrie.findDirs(cf.filename, dirs);
+
+            std::list<RFile*> dir_files;
+
+            for(std::list<RDirNode*>::iterator dit = dirs.begin(); dit != dirs.end(); dit++) {
+                (*dit)->getFilesRecursive(dir_files);
+            }
+
+            for(std::list<RFile*>::iterator fit = dir_files.begin(); fit != dir_files.end(); fit++) {
+                deleteFile(*fit);
+            }
+
+            continue;
+        }
+
+        if(cf.action == "D") {
+            std::map<std::string, RFile*>::iterator seen_file = files.find(cf.filename);
+
+            if(seen_file != files.end()) deleteFile(seen_file->second);
+
+            continue;
+        }
+
+        restoreFile(cf);
+    }
+}
+
+//lay out the files of every directory once after restoring many files at once
+void Gource::updateFilePositions() {
+    for(size_t i = 0; i < gGourceDirTrie.size(); i++) {
+        gGourceDirTrie.getDir(i)->fileUpdated(false);
+    }
+}
+
 Regex caption_regex("^(?:\\xEF\\xBB\\xBF)?([^|]+)\\|(.+)$");
 
 void Gource::loadCaptions() {
@@ -1177,71 +1876,126 @@ void Gource::readLog() {
         stop_position_reached = true;
     }
 
-    if((is_finished || stop_position_reached) && gGourceSettings.file_idle_time_at_end > 0.0f) {
+    if((is_finished || stop_position_reached) && gGourceSettings.file_idle_time_at_end > 0.0f
+       && gGourceSettings.file_idle_time != gGourceSettings.file_idle_time_at_end) {
       gGourceSettings.file_idle_time = gGourceSettings.file_idle_time_at_end;
+
+      //sleeping files need to be rescheduled with the new idle time
+      for(std::map<std::string,RFile*>::iterator it = files.begin(); it != files.end(); it++) {
+          it->second->wake();
+      }
     }
 
     // useful to figure out where we have crashes
     //debugLog("current date: %s\n", displaydate.c_str());
 }
 
-void Gource::processCommit(const RCommit& commit, float t) {
+//process the files of a commit up to max_files, removing them from the commit as they are done
+size_t Gource::processCommit(RCommit& commit, float t, size_t max_files) {
 
-    //find files of this commit or create it
-    for(std::list<RCommitFile>::const_iterator it = commit.files.begin(); it != commit.files.end(); it++) {
+    size_t processed = 0;
 
-        const RCommitFile& cf = *it;
-        RFile* file = 0;
+    addFiles(commit, max_files);
 
-        //is this a directory (ends in slash)
-        //deleting a directory - find directory: then for each file, remove each file
+    while(!commit.files.empty() && processed < max_files) {
+        const RCommitFile& cf = commit.files.front();
 
-        if(!cf.filename.empty() && cf.filename[cf.filename.size()-1] == '/') {
+        //a directory delete stays at the front of the commit until all its files are done
+        if(isDirectoryDelete(cf)) {
+            processed += processDirectoryDelete(commit, cf, t, max_files - processed);
 
-            //ignore unless it is a delete: we cannot 'add' or 'modify' a directory
-            //as its not a physical entity in Gource, only files are.
+            if(!dir_delete_started) commit.files.pop_front();
+            continue;
+        }
 
-            if(cf.action != "D") continue;
+        processed += processCommitFile(commit, cf, t);
+        commit.files.pop_front();
+    }
 
-            std::list<RDirNode*> dirs;
+    return processed;
+}
 
-            root->findDirs(cf.filename, dirs);
+bool Gource::isDirectoryDelete(const RCommitFile& cf) const {
+    return cf.action == "D" && !cf.filename.empty() && cf.filename[cf.filename.size()-1] == '/';
+}
 
-            for(std::list<RDirNode*>::iterator it = dirs.begin(); it != dirs.end(); it++) {
+//remove up to max_files of the files under a deleted directory, resuming where
+//the last call left off. returns the number of files affected
+size_t Gource::processDirectoryDelete(const RCommit& commit, const RCommitFile& cf, float t, size_t max_files) {
 
-                RDirNode* dir = (*it);
+    if(!dir_delete_started) {
+        std::list<RDirNode*> dirs;
 
-                //fprintf(stderr, "deleting everything under %s because of %s\n", dir->getPath().c_str(), cf.filename.c_str());
+        gGourceDirTrie.findDirs(cf.filename, dirs);
 
-                //foreach dir files
-                std::list<RFile*> dir_files;
+        for(std::list<RDirNode*>::iterator it = dirs.begin(); it != dirs.end(); it++) {
 
-                dir->getFilesRecursive(dir_files);
+            //fprintf(stderr, "deleting everything under %s because of %s\n", (*it)->getPath().c_str(), cf.filename.c_str());
 
-                for(std::list<RFile*>::iterator it = dir_files.begin(); it != dir_files.end(); it++) {
-                    RFile* file = *it;
+            std::list<RFile*> dir_files;
 
-                    addFileAction(commit, cf, file, t);
-                }
-            }
+            (*it)->getFilesRecursive(dir_files);
 
-            continue;
+            //keep paths rather than pointers, files can be deleted between frames
+            for(std::list<RFile*>::iterator fit = dir_files.begin(); fit != dir_files.end(); fit++) {
+                dir_delete_paths.push_back((*fit)->fullpath);
+            }
         }
 
-        std::map<std::string, RFile*>::iterator seen_file = files.find(cf.filename);
-        if(seen_file != files.end()) file = seen_file->second;
+        dir_delete_started = true;
+    }
 
-        if(file == 0) {
-            file = addFile(cf);
+    size_t affected = 0;
 
-            if(!file) continue;
-        }
+    while(!dir_delete_paths.empty() && affected < max_files) {
+
+        std::map<std::string, RFile*>::iterator seen_file = files.find(dir_delete_paths.front());
+        dir_delete_paths.pop_front();
+
+        if(seen_file == files.end()) continue;
+
+        addFileAction(commit, cf, seen_file->second, t);
+        affected++;
+    }
+
+    if(dir_delete_paths.empty()) dir_delete_started = false;
+
+    return std::max((size_t) 1, affected);
+}
+
+//returns the number of files affected
+size_t Gource::processCommitFile(const RCommit& commit, const RCommitFile& cf, float t) {
+
+    RFile* file = 0;
 
-        addFileAction(commit, cf, file, t);
+    //is this a directory (ends in slash)
+    //directory deletes are handled by processCommit
+
+    if(!cf.filename.empty() && cf.filename[cf.filename.size()-1] == '/') {
+
+        //ignore: we cannot 'add' or 'modify' a directory
+        //as its not a physical entity in Gource, only files are.
+
+        return 1;
+    }
+
+    std::map<std::string, RFile*>::iterator seen_file = files.find(cf.filename);
+    if(seen_file != files.end()) file = seen_file->second;
+
+    if(file == 0) {
+        file = addFile(cf);
+
+        if(!file) return 1;
     }
+
+    addFileAction(commit, cf, file, t);
+
+    return 1;
 }
 
 void Gource::addFileAction(const RCommit& commit, const RCommitFile& cf, RFile* file, float t) {
+    touchRecentFile(file);
+
     //create user if havent yet. do it here to ensure at least one of there files
     //was added (incase we hit gGourceSettings.max_files)
 
@@ -1249,8 +2003,8 @@ void Gource::addFileAction(const RCommit& commit, const RCommitFile& cf, RFile*
     RUser* user = 0;
 
     //see if user already exists
-    std::map<std::string, RUser*>::iterator seen_user = users.find(commit.username);
-    if(seen_user != users.end()) user = seen_user->second;
+    std::unordered_map<std::string, RUser*>::iterator seen_user = user_names.find(commit.username);
+    if(seen_user != user_names.end()) user = seen_user->second;
 
     if(user == 0) {
         user = addUser(commit.username);
@@ -1311,16 +2065,16 @@ void Gource::interactUsers() {
 
     userTree = new QuadTree(quadtreebounds, max_depth, 1);
 
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-        RUser* user = it->second;
+    for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+        RUser* user = *it;
 
         userTree->addItem(user);
     }
 
     //move users - interact with other users and files
-    for(std::map<std::string,RUser*>::iterator ait = users.begin(); ait!=users.end(); ait++) {
+    for(std::vector<RUser*>::iterator ait = users.begin(); ait != users.end(); ait++) {
 
-        RUser* a = ait->second;
+        RUser* a = *ait;
 
         UserForceFunctor uff(a);
         userTree->visitItemsInBounds(a->quadItemBounds, uff);
@@ -1334,11 +2088,13 @@ void Gource::interactUsers() {
 
 void Gource::updateBounds() {
 
+    root->updateAggregates();
+
     user_bounds.reset();
     active_user_bounds.reset();
 
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-        RUser* user = it->second;
+    for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+        RUser* user = *it;
 
         user->updateQuadItemBounds();
         user_bounds.update(user->quadItemBounds);
@@ -1351,8 +2107,8 @@ void Gource::updateBounds() {
 
     dir_bounds.reset();
 
-    for(std::map<std::string,RDirNode*>::iterator it = gGourceDirMap.begin(); it!=gGourceDirMap.end(); it++) {
-        RDirNode* node = it->second;
+    for(size_t i = 0; i < gGourceDirTrie.size(); i++) {
+        RDirNode* node = gGourceDirTrie.getDir(i);
 
         if(node->isVisible()) {
             node->updateQuadItemBounds();
@@ -1368,8 +2124,8 @@ void Gource::updateUsers(float t, float dt) {
     size_t idle_users = 0;
 
     // move users
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-        RUser* u = it->second;
+    for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+        RUser* u = *it;
 
         u->logic(t, dt);
 
@@ -1437,8 +2193,8 @@ void Gource::interactDirs() {
     dirNodeTree = new QuadTree(quadtreebounds, max_depth, 1);
 
     //apply forces with other directories
-    for(std::map<std::string,RDirNode*>::iterator it = gGourceDirMap.begin(); it!=gGourceDirMap.end(); it++) {
-        RDirNode* node = it->second;
+    for(size_t i = 0; i < gGourceDirTrie.size(); i++) {
+        RDirNode* node = gGourceDirTrie.getDir(i);
 
         if(!node->empty()) {
             dirNodeTree->addItem(node);
@@ -1449,8 +2205,19 @@ void Gource::interactDirs() {
 }
 
 void Gource::updateDirs(float dt) {
+
+    if(gGourceSettings.lod_threshold > 0.0f) {
+        //size of one unit of the scene in pixels at the current camera distance
+        float distance        = std::max(1.0f, -camera.getPos().z);
+        float pixels_per_unit = display.height * 0.5f / (distance * tanf(camera.getFOV() * 0.5f * DEGREES_TO_RADIANS));
+
+        root->updateDetail(pixels_per_unit, dt);
+    }
+
     root->applyForces(*dirNodeTree);
     root->logic(dt);
+
+    RFile::updateFiles(dt);
 }
 
 void Gource::updateTime(time_t display_time) {
@@ -1467,6 +2234,8 @@ void Gource::updateTime(time_t display_time) {
     strftime(datestr, 256, gGourceSettings.date_format.c_str(), timeinfo);
     displaydate = datestr;
 
+    if(gGourceSettings.benchmark) return;
+
     //avoid wobbling by only moving font if change is sufficient
     int date_offset = (int) fontmedium.getWidth(displaydate) * 0.5;
     if(abs(date_x_offset - date_offset) > 5) date_x_offset = date_offset;
@@ -1554,8 +2323,8 @@ void Gource::changeColours() {
 
     gStringHashSeed = (rand() % 10000) + 1;
 
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it != users.end(); it++) {
-        it->second->colourize();
+    for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+        (*it)->colourize();
     }
 
     for(std::map<std::string,RFile*>::iterator it = files.begin(); it != files.end(); it++) {
@@ -1601,7 +2370,9 @@ void Gource::logic(float t, float dt) {
             }
         }
 
-        if(gGourceSettings.start_position>0.0) {
+        if(gGourceSettings.catch_up && (gGourceSettings.start_position>0.0 || gGourceSettings.start_timestamp != 0)) {
+            catchUp();
+        } else if(gGourceSettings.start_position>0.0) {
             seekTo(gGourceSettings.start_position);
         }
     }
@@ -1663,8 +2434,8 @@ void Gource::logic(float t, float dt) {
 
             root->rotate(s, c, centre);
 
-            for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-                RUser* user = it->second;
+            for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+                RUser* user = *it;
 
                 vec2 rotated_user_pos = rotate_vec2(user->getPos() - centre, s, c) + centre;
                 user->setPos(rotated_user_pos);
@@ -1672,8 +2443,8 @@ void Gource::logic(float t, float dt) {
         } else {
             root->rotate(s, c);
 
-            for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-                RUser* user = it->second;
+            for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+                RUser* user = *it;
 
                 vec2 rotated_user_pos = rotate_vec2(user->getPos(), s, c);
                 user->setPos(rotated_user_pos);
@@ -1699,10 +2470,21 @@ void Gource::logic(float t, float dt) {
     }
 
     // get more entries
-    if(commitqueue.empty()) {
-        readLog();
+    phase_start = SDL_GetPerformanceCounter();
+
+    //every commit read so far has been processed so the scene matches the log position
+    if(commitqueue.empty() && commitlog->isSeekable() && !stop_position_reached && needCheckpoint(commitlog->getPercent())) {
+        beginCheckpoint(true);
     }
 
+    //snapshot a bounded number of files each frame
+    if(pending_checkpoint != 0) updateCheckpoint(gGourceCheckpointBudget);
+
+    if(catching_up) catchUp();
+    else if(commitqueue.empty()) readLog();
+
+    endPhase(GOURCE_PHASE_READ_LOG);
+
     //loop in attempt to find commits
     if(gGourceSettings.loop && commitqueue.empty() && commitlog->isSeekable()) {
         if(idle_time >= gGourceSettings.loop_delay_seconds) {
@@ -1732,18 +2514,20 @@ void Gource::logic(float t, float dt) {
 
     currtime += seconds;
 
-    // delete files
-    for(std::vector<RFile*>::iterator it = gGourceRemovedFiles.begin(); it != gGourceRemovedFiles.end(); it++) {
-        deleteFile(*it);
+    // delete files, each taking itself off the list
+    while(!gGourceRemovedFiles.empty()) {
+        deleteFile(gGourceRemovedFiles.back());
     }
 
-    gGourceRemovedFiles.clear();
-
 
     //add commits up until the current time
-    while(!commitqueue.empty()) {
+    phase_start = SDL_GetPerformanceCounter();
+
+    size_t file_budget = gGourceCommitFileBudget;
 
-        RCommit commit = commitqueue.front();
+    while(!commitqueue.empty() && file_budget > 0) {
+
+        RCommit& commit = commitqueue.front();
 
         //auto skip ahead, unless stop_position_reached
         if(gGourceSettings.auto_skip_seconds>=0.0 && idle_time >= gGourceSettings.auto_skip_seconds && !stop_position_reached) {
@@ -1753,7 +2537,15 @@ void Gource::logic(float t, float dt) {
 
         if(commit.timestamp > currtime) break;
 
-        processCommit(commit, t);
+        size_t processed = processCommit(commit, t, file_budget);
+
+        file_budget -= std::min(processed, file_budget);
+        processed_commit_files += processed;
+
+        //carry the rest of a large commit over to the next frame
+        if(!commit.files.empty()) break;
+
+        processed_commits++;
 
         if(gGourceSettings.no_time_travel) {
             if(commit.timestamp > lasttime) {
@@ -1773,8 +2565,43 @@ void Gource::logic(float t, float dt) {
         commitqueue.pop_front();
     }
 
+    endPhase(GOURCE_PHASE_PROCESS_COMMITS);
+
     slider.resize();
 
+    //captions are only laid out when rendering
+    if(!gGourceSettings.benchmark) updateCaptions(dt);
+
+    //reset loop counters
+    gGourceUserInnerLoops = 0;
+    gGourceDirNodeInnerLoops = 0;
+    gGourceFileInnerLoops = 0;
+
+    phase_start = SDL_GetPerformanceCounter();
+
+    updateBounds();
+    endPhase(GOURCE_PHASE_UPDATE_BOUNDS);
+
+    interactUsers();
+    endPhase(GOURCE_PHASE_INTERACT_USERS);
+
+    updateUsers(t, dt);
+    endPhase(GOURCE_PHASE_UPDATE_USERS);
+
+    interactDirs();
+    endPhase(GOURCE_PHASE_INTERACT_DIRS);
+
+    updateDirs(dt);
+    endPhase(GOURCE_PHASE_UPDATE_DIRS);
+
+    updateCamera(dt);
+    endPhase(GOURCE_PHASE_UPDATE_CAMERA);
+
+    updateTime(!commitqueue.empty() ? currtime : lasttime);
+}
+
+void Gource::updateCaptions(float dt) {
+
     float caption_height  = fontcaption.getMaxHeight();
     float caption_start_y = canSeek() ? slider.getBounds().min.y - 35.0f : display.height - fontmedium.getMaxHeight() - 20.0f;
 
@@ -1858,23 +2685,6 @@ void Gource::logic(float t, float dt) {
 
          it++;
     }
-
-    //reset loop counters
-    gGourceUserInnerLoops = 0;
-    gGourceDirNodeInnerLoops = 0;
-    gGourceFileInnerLoops = 0;
-
-    updateBounds();
-
-    interactUsers();
-    updateUsers(t, dt);
-
-    interactDirs();
-    updateDirs(dt);
-
-    updateCamera(dt);
-
-    updateTime(!commitqueue.empty() ? currtime : lasttime);
 }
 
 void Gource::mousetrace(float dt) {
@@ -1991,6 +2801,7 @@ void Gource::mousetrace(float dt) {
 void Gource::loadingScreen() {
     if(!gGourceDrawBackground) return;
     display.mode2D();
+    gGourceFrameTiles.applyProjection();
 
     glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
@@ -2124,6 +2935,7 @@ void Gource::updateAndDrawEdges() {
     glPushMatrix();
     glLoadIdentity();
     glOrtho(0, display.width, display.height, 0, -1.0, 1.0);
+    gGourceFrameTiles.applyProjection();
 
     glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
@@ -2141,7 +2953,9 @@ void Gource::updateAndDrawEdges() {
 
         root->updateEdgeVBO(edge_vbo);
 
+        Uint64 upload_start = SDL_GetPerformanceCounter();
         edge_vbo.update();
+        edge_upload_time = elapsedMs(upload_start);
 
         shadow_shader->setSampler2D("tex", 0);
         shadow_shader->setFloat("shadow_strength", 0.5);
@@ -2187,8 +3001,8 @@ void Gource::drawActions(float dt) {
     } else {
 
         //draw actions
-        for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-            it->second->drawActions(dt);
+        for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+            (*it)->drawActions(dt);
         }
     }
 }
@@ -2202,7 +3016,8 @@ void Gource::drawBloom(float dt) {
 
     if(!gGourceSettings.ffp) {
 
-        bloom_shader->use();
+        if(bloom_vbo.isInstanced()) bloom_sprite_shader->use();
+        else bloom_shader->use();
 
         bloom_vbo.draw();
 
@@ -2258,12 +3073,12 @@ void Gource::updateVBOs(float dt) {
 
     if(!gGourceSettings.hide_users) {
 
-        user_vbo.reset();
+        user_sprites.reset();
         action_vbo.reset();
 
         //use a separate vbo for each user texture
-        for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-            RUser* user = it->second;
+        for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+            RUser* user = *it;
 
             float alpha = user->getAlpha();
             vec3 col   = user->getColour();
@@ -2272,26 +3087,37 @@ void Gource::updateVBOs(float dt) {
 
             if(gGourceSettings.fixed_user_size) scaled_dims *= (-camera.getPos().z / -starting_z);
 
-            user_vbo.add(user->graphic->textureid, user->getPos() - scaled_dims*0.5f, scaled_dims, vec4(col.x, col.y, col.z, alpha));
+            user_sprites.add(user->graphic->textureid, user->getPos() - scaled_dims*0.5f, scaled_dims, vec4(col.x, col.y, col.z, alpha));
 
             //draw actions
             user->updateActionsVBO(action_vbo);
         }
 
-        user_vbo.update();
+        Uint64 upload_start = SDL_GetPerformanceCounter();
+        user_sprites.update();
+        user_upload_time = elapsedMs(upload_start);
+
+        upload_start = SDL_GetPerformanceCounter();
         action_vbo.update();
+        action_upload_time = elapsedMs(upload_start);
     }
 
     if(!gGourceSettings.hide_bloom) {
         bloom_vbo.reset();
         root->updateBloomVBO(bloom_vbo, dt);
+
+        Uint64 upload_start = SDL_GetPerformanceCounter();
         bloom_vbo.update();
+        bloom_upload_time = elapsedMs(upload_start);
     }
 
     if(!gGourceSettings.hide_files) {
-        file_vbo.reset();
-        root->updateFilesVBO(file_vbo, dt);
-        file_vbo.update();
+        file_sprites.reset();
+        root->updateFilesVBO(file_sprites, dt);
+
+        Uint64 upload_start = SDL_GetPerformanceCounter();
+        file_sprites.update();
+        file_upload_time = elapsedMs(upload_start);
     }
 }
 
@@ -2304,15 +3130,21 @@ void Gource::drawFileShadows(float dt) {
 
     if(!gGourceSettings.ffp) {
 
-        shadow_shader->setSampler2D("tex", 0);
-        shadow_shader->setFloat("shadow_strength", 0.5);
-        shadow_shader->use();
+        Shader* shader = sprite_shader != 0 ? sprite_shader : shadow_shader;
+
+        shader->setSampler2D("tex", 0);
+        shader->setFloat("shadow_strength", 0.5);
+        if(sprite_shader != 0) shader->setFloat("textured", 1.0);
+        shader->use();
 
         glBindTexture(GL_TEXTURE_2D, gGourceSettings.file_graphic->textureid);
 
         glPushMatrix();
             glTranslatef(2.0f, 2.0f, 0.0f);
-            file_vbo.draw();
+
+            if(sprite_shader != 0) file_sprites.draw();
+            else file_vbo.draw();
+
         glPopMatrix();
 
         glUseProgramObjectARB(0);
@@ -2330,23 +3162,27 @@ void Gource::drawUserShadows(float dt) {
 
     if(!gGourceSettings.ffp) {
 
-        shadow_shader->setSampler2D("tex", 0);
-        shadow_shader->setFloat("shadow_strength", 0.5);
-        shadow_shader->use();
+        Shader* shader = sprite_shader != 0 ? sprite_shader : shadow_shader;
+
+        shader->setSampler2D("tex", 0);
+        shader->setFloat("shadow_strength", 0.5);
+        if(sprite_shader != 0) shader->setFloat("textured", 1.0);
+        shader->use();
 
         vec2 shadow_offset = vec2(2.0, 2.0) * gGourceSettings.user_scale;
 
         glPushMatrix();
             glTranslatef(shadow_offset.x, shadow_offset.y, 0.0f);
 
-            user_vbo.draw();
+            if(sprite_shader != 0) user_sprites.draw();
+            else user_vbo.draw();
 
         glPopMatrix();
 
         glUseProgramObjectARB(0);
     } else {
-        for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-            it->second->drawShadow(dt);
+        for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+            (*it)->drawShadow(dt);
         }
     }
 }
@@ -2367,7 +3203,19 @@ void Gource::drawFiles(float dt) {
     if(!gGourceSettings.ffp) {
         glBindTexture(GL_TEXTURE_2D, gGourceSettings.file_graphic->textureid);
 
-        file_vbo.draw();
+        if(sprite_shader != 0) {
+            sprite_shader->setSampler2D("tex", 0);
+            sprite_shader->setFloat("shadow_strength", 0.0);
+            //trace debug draws untextured, which glDisable(GL_TEXTURE_2D) does not do for a shader
+            sprite_shader->setFloat("textured", trace_debug ? 0.0 : 1.0);
+            sprite_shader->use();
+
+            file_sprites.draw();
+
+            glUseProgramObjectARB(0);
+        } else {
+            file_vbo.draw();
+        }
     } else {
         root->drawFiles(dt);
     }
@@ -2387,12 +3235,23 @@ void Gource::drawUsers(float dt) {
 
     if(!gGourceSettings.ffp) {
 
-        user_vbo.draw();
+        if(sprite_shader != 0) {
+            sprite_shader->setSampler2D("tex", 0);
+            sprite_shader->setFloat("shadow_strength", 0.0);
+            sprite_shader->setFloat("textured", trace_debug ? 0.0 : 1.0);
+            sprite_shader->use();
+
+            user_sprites.draw();
+
+            glUseProgramObjectARB(0);
+        } else {
+            user_vbo.draw();
+        }
 
     } else {
 
-        for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-            it->second->draw(dt);
+        for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+            (*it)->draw(dt);
         }
     }
 
@@ -2401,6 +3260,7 @@ void Gource::drawUsers(float dt) {
 void Gource::draw(float t, float dt) {
 
     display.mode2D();
+    gGourceFrameTiles.applyProjection();
 
     drawBackground(dt);
 
@@ -2442,14 +3302,17 @@ void Gource::draw(float t, float dt) {
     GLdouble modelview[16];
     GLdouble projection[16];
 
-    glGetIntegerv( GL_VIEWPORT, viewport );
+    //screen positions are relative to the whole frame, not the current tile
+    gGourceFrameTiles.getViewport( viewport );
     glGetDoublev( GL_MODELVIEW_MATRIX, modelview );
     glGetDoublev( GL_PROJECTION_MATRIX, projection );
 
+    gGourceFrameTiles.applyProjection();
+
     root->calcScreenPos(viewport, modelview, projection);
 
-    for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-        it->second->calcScreenPos(viewport, modelview, projection);
+    for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+        (*it)->calcScreenPos(viewport, modelview, projection);
     }
 
     //need to calc screen pos of selected file if hiding other
@@ -2486,6 +3349,7 @@ void Gource::draw(float t, float dt) {
 
     //switch to 2D, preserve current state
     display.push2D();
+    gGourceFrameTiles.applyProjection();
 
     if(!gGourceSettings.ffp) {
         fontmanager.startBuffer();
@@ -2497,8 +3361,8 @@ void Gource::draw(float t, float dt) {
     root->drawNames(fontdirname);
 
    if(!(gGourceSettings.hide_usernames || gGourceSettings.hide_users)) {
-        for(std::map<std::string,RUser*>::iterator it = users.begin(); it!=users.end(); it++) {
-            RUser* user = it->second;
+        for(std::vector<RUser*>::iterator it = users.begin(); it != users.end(); it++) {
+            RUser* user = *it;
             if(!user->isSelected()) {
                 user->drawName();
             }
@@ -2514,7 +3378,9 @@ void Gource::draw(float t, float dt) {
 
         text_vbo_commit_time = SDL_GetTicks();
 
+        Uint64 upload_start = SDL_GetPerformanceCounter();
         fontmanager.commitBuffer();
+        text_upload_time = elapsedMs(upload_start);
 
         text_vbo_commit_time = SDL_GetTicks() - text_vbo_commit_time;
 
@@ -2573,6 +3439,7 @@ void Gource::draw(float t, float dt) {
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
     display.mode2D();
+    gGourceFrameTiles.applyProjection();
 
     glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
@@ -2705,8 +3572,8 @@ void Gource::draw(float t, float dt) {
             gGourceSettings.days_per_second);
         font.print(1,60,"Commit Queue: %d", commitqueue.size());
         font.print(1,80,"Users: %d", users.size());
-        font.print(1,100,"Files: %d", files.size());
-        font.print(1,120,"Dirs: %d",  gGourceDirMap.size());
+        font.print(1,100,"Files: %d (%d active)", files.size(), gGourceActiveFiles.size());
+        font.print(1,120,"Dirs: %d",  gGourceDirTrie.size());
 
         font.print(1,140,"Log Position: %.4f", commitlog->getPercent());
         font.print(1,160,"Camera: (%.2f, %.2f, %.2f)", campos.x, campos.y, campos.z);
@@ -2738,12 +3605,17 @@ void Gource::draw(float t, float dt) {
         font.print(1,600,"String Hash Seed: %d", gStringHashSeed);
 
         if(!gGourceSettings.ffp) {
-            font.print(1,620,"Text VBO: %d/%d vertices, %d texture changes", fontmanager.font_vbo.vertices(), fontmanager.font_vbo.capacity(), fontmanager.font_vbo.texture_changes());
-            font.print(1,640,"File VBO: %d/%d vertices, %d texture changes", file_vbo.vertices(), file_vbo.capacity(), file_vbo.texture_changes());
-            font.print(1,660,"User VBO: %d/%d vertices, %d texture changes", user_vbo.vertices(), user_vbo.capacity(), user_vbo.texture_changes());
-            font.print(1,680,"Action VBO: %d/%d vertices", action_vbo.vertices(), action_vbo.capacity());
-            font.print(1,700,"Bloom VBO: %d/%d vertices", bloom_vbo.vertices(), bloom_vbo.capacity());
-            font.print(1,720,"Edge VBO: %d/%d vertices",  edge_vbo.vertices(), edge_vbo.capacity());
+            font.print(1,620,"Text VBO: %d/%d vertices, %d texture changes, upload %.3f ms", fontmanager.font_vbo.vertices(), fontmanager.font_vbo.capacity(), fontmanager.font_vbo.texture_changes(), text_upload_time);
+            if(sprite_shader != 0) {
+                font.print(1,640,"File Sprites: %d/%d instances, %d texture changes, upload %.3f ms", file_sprites.sprites(), file_sprites.capacity(), file_sprites.texture_changes(), file_upload_time);
+                font.print(1,660,"User Sprites: %d/%d instances, %d texture changes, upload %.3f ms", user_sprites.sprites(), user_sprites.capacity(), user_sprites.texture_changes(), user_upload_time);
+            } else {
+                font.print(1,640,"File VBO: %d/%d vertices, %d texture changes, upload %.3f ms", file_vbo.vertices(), file_vbo.capacity(), file_vbo.texture_changes(), file_upload_time);
+                font.print(1,660,"User VBO: %d/%d vertices, %d texture changes, upload %.3f ms", user_vbo.vertices(), user_vbo.capacity(), user_vbo.texture_changes(), user_upload_time);
+            }
+            font.print(1,680,"Action VBO: %d/%d vertices, upload %.3f ms", action_vbo.vertices(), action_vbo.capacity(), action_upload_time);
+            font.print(1,700,"Bloom VBO: %d quads%s, upload %.3f ms (%s)", bloom_vbo.quads(), bloom_vbo.isInstanced() ? " (instanced)" : "", bloom_upload_time, bloom_vbo.persistent() ? "persistent" : "orphaned");
+            font.print(1,720,"Edge VBO: %d/%d vertices, upload %.3f ms",  edge_vbo.vertices(), edge_vbo.capacity(), edge_upload_time);
         }
 
         if(selectedUser != 0) {
@@ -2754,6 +3626,20 @@ void Gource::draw(float t, float dt) {
             font.print(1,740,"%s: %d files (%d visible)", selectedFile->getDir()->getPath().c_str(),
                     selectedFile->getDir()->fileCount(), selectedFile->getDir()->visibleFileCount());
         }
+
+#ifdef GOURCE_ALLOCATION_STATS
+        font.print(1,760,"Action Pool: %d/%d (%d slabs, %d allocations)", gGourceActionPool.objectsInUse(), gGourceActionPool.capacity(), gGourceActionPool.slabCount(), gGourceActionPool.allocationCount());
+        font.print(1,780,"File Pool: %d/%d (%d slabs, %d allocations)",   gGourceFilePool.objectsInUse(),   gGourceFilePool.capacity(),   gGourceFilePool.slabCount(),   gGourceFilePool.allocationCount());
+        font.print(1,800,"Dir Pool: %d/%d (%d slabs, %d allocations)",    gGourceDirNodePool.objectsInUse(), gGourceDirNodePool.capacity(), gGourceDirNodePool.slabCount(), gGourceDirNodePool.allocationCount());
+        font.print(1,820,"User Pool: %d/%d (%d slabs, %d allocations)",   gGourceUserPool.objectsInUse(),   gGourceUserPool.capacity(),   gGourceUserPool.slabCount(),   gGourceUserPool.allocationCount());
+        font.print(1,860,"Heap allocations: %d", RObjectPool::heapAllocationCount());
+#else
+        font.print(1,760,"Action Pool: %d/%d (%d slabs)", gGourceActionPool.objectsInUse(), gGourceActionPool.capacity(), gGourceActionPool.slabCount());
+        font.print(1,780,"File Pool: %d/%d (%d slabs)",   gGourceFilePool.objectsInUse(),   gGourceFilePool.capacity(),   gGourceFilePool.slabCount());
+        font.print(1,800,"Dir Pool: %d/%d (%d slabs)",    gGourceDirNodePool.objectsInUse(), gGourceDirNodePool.capacity(), gGourceDirNodePool.slabCount());
+        font.print(1,820,"User Pool: %d/%d (%d slabs)",   gGourceUserPool.objectsInUse(),   gGourceUserPool.capacity(),   gGourceUserPool.slabCount());
+#endif
+        font.print(1,840,"Checkpoints: %d", checkpoints.size());
     }
 
     mousemoved=false;
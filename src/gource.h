@@ -21,6 +21,8 @@
 #include <deque>
 #include <list>
 #include <fstream>
+#include <algorithm>
+#include <unordered_map>
 
 #include "core/display.h"
 #include "core/shader.h"
@@ -48,11 +50,26 @@
 #include "dirnode.h"
 #include "zoomcamera.h"
 #include "key.h"
+#include "checkpoint.h"
+#include "exporter.h"
+#include "tiles.h"
+
+enum {
+    GOURCE_PHASE_READ_LOG,
+    GOURCE_PHASE_PROCESS_COMMITS,
+    GOURCE_PHASE_UPDATE_BOUNDS,
+    GOURCE_PHASE_INTERACT_USERS,
+    GOURCE_PHASE_UPDATE_USERS,
+    GOURCE_PHASE_INTERACT_DIRS,
+    GOURCE_PHASE_UPDATE_DIRS,
+    GOURCE_PHASE_UPDATE_CAMERA,
+    GOURCE_PHASE_COUNT
+};
 
 class Gource : public SDLApp {
     std::string logfile;
 
-    FrameExporter* frameExporter;
+    RFrameExporter* frameExporter;
 
     RLogMill* logmill;
 
@@ -92,6 +109,8 @@ class Gource : public SDLApp {
 
     bool stop_position_reached;
 
+    bool catching_up;
+
     int tag_seq, commit_seq;
 
     GLint mouse_hits;
@@ -109,6 +128,11 @@ class Gource : public SDLApp {
 
     bloombuf bloom_vbo;
 
+    //files and users are drawn as instances when supported, otherwise
+    //the sprites are expanded into file_vbo and user_vbo
+    spritebuf file_sprites;
+    spritebuf user_sprites;
+
     GLuint selectionDepth;
 
     RDirNode* root;
@@ -125,6 +149,8 @@ class Gource : public SDLApp {
     Shader*          shadow_shader;
     Shader*          text_shader;
     Shader*          bloom_shader;
+    Shader*          sprite_shader;
+    Shader*          bloom_sprite_shader;
 
     float font_texel_size;
 
@@ -141,6 +167,7 @@ class Gource : public SDLApp {
     float max_tick_rate;
     int frameskip;
     int framecount;
+    int export_frame;
 
     time_t currtime;
     time_t lasttime;
@@ -169,6 +196,23 @@ class Gource : public SDLApp {
     Uint32 text_vbo_commit_time;
     Uint32 text_vbo_draw_time;
 
+    //time to upload each vertex buffer this frame in ms
+    float file_upload_time;
+    float user_upload_time;
+    float action_upload_time;
+    float edge_upload_time;
+    float bloom_upload_time;
+    float text_upload_time;
+
+    //accumulated time spent in each phase of logic()
+    Uint64 phase_ticks[GOURCE_PHASE_COUNT];
+    Uint64 phase_start;
+
+    int processed_commits;
+    int processed_commit_files;
+
+    void endPhase(int phase);
+
     bool track_users;
 
     Bounds2D dir_bounds;
@@ -179,10 +223,29 @@ class Gource : public SDLApp {
     float starting_z;
 
     std::deque<RCommit> commitqueue;
-    std::map<std::string, RUser*> users;
+
+    //files still to be removed by the directory delete at the front of the commit queue
+    std::deque<std::string> dir_delete_paths;
+    bool dir_delete_started;
+    //users stored contiguously for the per frame loops, with a separate index by name
+    std::vector<RUser*> users;
+    std::unordered_map<std::string, RUser*> user_names;
     std::map<std::string, RFile*> files;
+
+    //files by when they were last touched, most recent first (--max-files-lru)
+    std::list<RFile*> recent_files;
     std::map<int, RUser*> tagusermap;
 
+    std::vector<RCheckpoint*> checkpoints;
+    RCheckpointPaths checkpoint_paths;
+
+    //checkpoint being built over several frames
+    RCheckpoint* pending_checkpoint;
+    std::string checkpoint_cursor;
+    size_t checkpoint_dir_index;
+    bool checkpoint_files_done;
+    bool checkpoint_layout;
+
     std::list<RCaption*> captions;
     std::list<RCaption*> active_captions;
 
@@ -197,11 +260,17 @@ class Gource : public SDLApp {
     void reset();
 
     RUser* addUser(const std::string& username);
+    RFile* createFile(const RCommitFile& cf);
     RFile* addFile(const RCommitFile& cf);
+    void addFiles(const RCommit& commit, size_t max_files);
+    void addFileGroup(const std::vector<RFile*>& group);
 
     void deleteUser(RUser* user);
     void deleteFile(RFile* file);
 
+    void touchRecentFile(RFile* file);
+    void evictFile();
+
     void selectBackground();
     void selectUser(RUser* user);
     void selectFile(RFile* file);
@@ -213,7 +282,11 @@ class Gource : public SDLApp {
 
     void logReadingError(const std::string& error);
 
-    void processCommit(const RCommit& commit, float t);
+    size_t processCommit(RCommit& commit, float t, size_t max_files);
+    size_t processCommitFile(const RCommit& commit, const RCommitFile& cf, float t);
+
+    bool isDirectoryDelete(const RCommitFile& cf) const;
+    size_t processDirectoryDelete(const RCommit& commit, const RCommitFile& cf, float t, size_t max_files);
     void addFileAction(const RCommit& commit, const RCommitFile& cf, RFile* file, float t);
 
     std::string dateAtPosition(float percent);
@@ -228,14 +301,35 @@ class Gource : public SDLApp {
     void interactUsers();
     void interactDirs();
 
+    void updateCaptions(float dt);
+
     void updateBounds();
 
     void updateTime(time_t display_time);
 
+    void step(float dt);
+    void skipTicks(float dt);
+    void drawTiles(float t, float dt);
+
     void mousetrace(float dt);
 
     bool canSeek();
-    void seekTo(float percent);
+
+    bool needCheckpoint(float percent);
+    void beginCheckpoint(bool save_layout);
+    bool updateCheckpoint(size_t max_items);
+    void discardCheckpoint();
+    RCheckpoint* findCheckpoint(float percent);
+    void restoreCheckpoint(const RCheckpoint& checkpoint);
+    void fastForward(float percent);
+
+    void catchUp();
+    bool catchUpToDate();
+    void settleLayout();
+
+    RFile* restoreFile(const RCommitFile& cf);
+    void applyCommit(const RCommit& commit);
+    void updateFilePositions();
 
     void zoom(bool zoomin);
 
@@ -261,14 +355,14 @@ class Gource : public SDLApp {
 
     void grabMouse(bool grab_mouse);
 public:
-    Gource(FrameExporter* frameExporter = 0);
+    Gource(RFrameExporter* frameExporter = 0);
     ~Gource();
 
     static void writeCustomLog(const std::string& logfile, const std::string& output_file);
 
     void setCameraMode(const std::string& mode);
     void setCameraMode(bool track_users);
-    void setFrameExporter(FrameExporter* exporter, int video_framerate);
+    void setFrameExporter(RFrameExporter* exporter, int video_framerate);
 
     void showSplash();
 
@@ -277,6 +371,27 @@ public:
     void logic(float t, float dt);
     void draw(float t, float dt);
 
+    void simulate(float dt);
+
+    bool isLoading();
+
+    size_t getFileCount() const;
+    size_t getUserCount() const;
+    size_t getDirCount() const;
+
+    int getProcessedCommits() const;
+    int getProcessedCommitFiles() const;
+
+    void seekTo(float percent);
+
+    size_t getCheckpointCount() const;
+
+    //paths of the files in the scene that are not being removed
+    void getFilePaths(std::vector<std::string>& paths) const;
+
+    double getPhaseSeconds(int phase) const;
+    static const char* getPhaseName(int phase);
+
     void init();
 
     void unload();
@@ -65,6 +65,7 @@ void GourceSettings::help(bool extended_help) {
     printf("  --stop-date  'YYYY-MM-DD hh:mm:ss +tz'  Stop at a date and optional time\n\n");
     printf("  -p, --start-position POSITION    Start at some position (0.0-1.0 or 'random')\n");
     printf("      --stop-position  POSITION    Stop at some position\n");
+    printf("      --catch-up                   Apply history before the start to the tree\n");
     printf("  -t, --stop-at-time SECONDS       Stop after a specified number of seconds\n");
     printf("      --stop-at-end                Stop at end of the log\n");
     printf("      --dont-stop                  Keep running after the end of the log\n");
@@ -93,6 +94,7 @@ void GourceSettings::help(bool extended_help) {
     printf("  --file-idle-time-at-end SECONDS  Time files remain idle at end (default: 0)\n\n");
 
     printf("  --max-files NUMBER      Max number of files or 0 for no limit\n");
+    printf("  --max-files-lru         Replace the least recently touched files at the limit\n");
     printf("  --max-file-lag SECONDS  Max time files of a commit can take to appear\n\n");
 
     printf("  --log-command VCS       Show the VCS log command (git,svn,hg,bzr,cvs2cl)\n");
@@ -102,7 +104,14 @@ void GourceSettings::help(bool extended_help) {
     printf("  --save-config CONF_FILE  Save a config file with the current options\n\n");
 
     printf("  -o, --output-ppm-stream FILE    Output PPM stream to a file ('-' for STDOUT)\n");
-    printf("  -r, --output-framerate  FPS     Framerate of output (25,30,60)\n\n");
+    printf("  -r, --output-framerate  FPS     Framerate of output (25,30,60)\n");
+    printf("      --output-format     FORMAT  Output format (ppm,y4m,i420,nv12)\n");
+    printf("      --output-timecodes  FILE    Drop repeated frames and write their timecodes\n");
+    printf("      --output-frame-range START:END  Only output frames START to END-1\n");
+    printf("      --output-tiles      CxR     Render each frame as a grid of tiles\n");
+    printf("      --offscreen                 Render the output without a window\n\n");
+
+    printf("  --benchmark             Simulate the log without rendering and report timings\n\n");
 
 if(extended_help) {
     printf("Extended Options:\n\n");
@@ -179,13 +188,17 @@ if(extended_help) {
 
     printf("  --filename-time SECONDS  Duration to keep filenames on screen (default: 4.0)\n\n");
 
+    printf("  --lod-threshold PIXELS   Collapse directories smaller than this on screen\n");
+    printf("                           into a single node (default: 0, disabled)\n\n");
+
     printf("  --caption-file FILE         Caption file\n");
     printf("  --caption-size SIZE         Caption font size\n");
     printf("  --caption-colour FFFFFF     Caption colour in hex\n");
     printf("  --caption-duration SECONDS  Caption duration (default: 10.0)\n");
     printf("  --caption-offset X          Caption horizontal offset\n\n");
 
-    printf("  --hash-seed SEED         Change the seed of hash function.\n\n");
+    printf("  --hash-seed SEED         Change the seed of hash function.\n");
+    printf("  --random-seed SEED       Seed the simulation so runs are repeatable.\n\n");
 
     printf("  --path PATH\n\n");
 }
@@ -213,6 +226,8 @@ GourceSettings::GourceSettings() {
     file_graphic = 0;
     log_level = LOG_LEVEL_OFF;
     shutdown = false;
+    benchmark = false;
+    offscreen = false;
 
     setGourceDefaults();
 
@@ -249,12 +264,15 @@ GourceSettings::GourceSettings() {
     conf_sections["save-config"]     = "command-line";
     conf_sections["output-custom-log"] = "command-line";
     conf_sections["log-level"]         = "command-line";
+    conf_sections["benchmark"]         = "command-line";
+    conf_sections["offscreen"]         = "command-line";
 
     //boolean args
     arg_types["help"]                    = "bool";
     arg_types["extended-help"]           = "bool";
     arg_types["stop-on-idle"]            = "bool";
     arg_types["stop-at-end"]             = "bool";
+    arg_types["catch-up"]                = "bool";
     arg_types["dont-stop"]               = "bool";
     arg_types["loop"]                    = "bool";
     arg_types["realtime"]                = "bool";
@@ -279,6 +297,8 @@ GourceSettings::GourceSettings() {
     arg_types["author-time"]             = "bool";
     arg_types["key"]                     = "bool";
     arg_types["ffp"]                     = "bool";
+    arg_types["benchmark"]               = "bool";
+    arg_types["offscreen"]               = "bool";
 
     arg_types["disable-auto-rotate"] = "bool";
     arg_types["disable-auto-skip"]   = "bool";
@@ -305,12 +325,14 @@ GourceSettings::GourceSettings() {
     arg_types["loop-delay-seconds"] = "float";
 
     arg_types["max-files"] = "int";
+    arg_types["max-files-lru"] = "bool";
     arg_types["font-size"] = "int";
     arg_types["font-scale"] = "float";
     arg_types["file-font-size"] = "int";
     arg_types["dir-font-size"] = "int";
     arg_types["user-font-size"] = "int";
     arg_types["hash-seed"] = "int";
+    arg_types["random-seed"] = "int";
 
     arg_types["user-filter"]      = "multi-value";
     arg_types["user-show-filter"] = "multi-value";
@@ -346,6 +368,10 @@ GourceSettings::GourceSettings() {
     arg_types["max-file-lag"]       = "string";
     arg_types["user-scale"]         = "string";
     arg_types["camera-mode"]        = "string";
+    arg_types["output-format"]      = "string";
+    arg_types["output-timecodes"]   = "string";
+    arg_types["output-frame-range"] = "string";
+    arg_types["output-tiles"]       = "string";
     arg_types["title"]              = "string";
     arg_types["font-file"]          = "string";
     arg_types["font-colour"]        = "string";
@@ -361,6 +387,7 @@ GourceSettings::GourceSettings() {
 
     arg_types["filename-colour"]    = "string";
     arg_types["filename-time"]      = "float";
+    arg_types["lod-threshold"]      = "float";
 
     arg_types["dir-name-depth"]     = "int";
 }
@@ -395,6 +422,7 @@ void GourceSettings::setGourceDefaults() {
     stop_at_time    = -1.0f;
     stop_on_idle    = false;
     stop_at_end     = false;
+    catch_up        = false;
     dont_stop       = false;
     no_time_travel  = false;
     fixed_user_size = false;
@@ -428,6 +456,15 @@ void GourceSettings::setGourceDefaults() {
     camera_zoom_max     = 10000.0f;
 
     camera_mode     = "overview";
+    output_format   = "ppm";
+    output_timecodes_filename = "";
+    output_frame_start = 0;
+    output_frame_end   = -1;
+    output_tile_columns = 1;
+    output_tile_rows    = 1;
+
+    deterministic = false;
+    random_seed   = 0;
     padding         = 1.1f;
 
     crop_vertical   = false;
@@ -465,6 +502,7 @@ void GourceSettings::setGourceDefaults() {
     date_format = "%A, %d %B, %Y %X";
 
     max_files      = 0;
+    max_files_lru  = false;
     max_user_speed = 500.0f;
     max_file_lag   = 5.0f;
 
@@ -486,6 +524,8 @@ void GourceSettings::setGourceDefaults() {
     filename_colour  = vec3(1.0f, 1.0f, 1.0f);
     filename_time = 4.0f;
 
+    lod_threshold = 0.0f;
+
     gStringHashSeed = 31;
 
     //delete file filters
@@ -526,6 +566,15 @@ void GourceSettings::setScaledFontSizes() {
     scaled_filename_font_size  = glm::clamp((int)(filename_font_size * font_scale), 1, 100);
 }
 
+//recording a video kind of implies you want this, unless:
+// -- dont stop requested
+// -- loop requested
+// -- reading from STDIN
+void GourceSettings::setRecordingStopAtEnd() {
+    if(!(dont_stop || loop || path == "-"))
+        stop_at_end = true;
+}
+
 void GourceSettings::commandLineOption(const std::string& name, const std::string& value) {
 
     if(name == "help") {
@@ -585,6 +634,16 @@ void GourceSettings::commandLineOption(const std::string& name, const std::strin
         return;
     }
 
+    if(name == "benchmark") {
+        benchmark = true;
+        return;
+    }
+
+    if(name == "offscreen") {
+        offscreen = true;
+        return;
+    }
+
     if(name == "log-level") {
         if(value == "warn") {
             log_level = LOG_LEVEL_WARN;
@@ -949,6 +1008,17 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
         }
     }
 
+    if((entry = gource_settings->getEntry("lod-threshold")) != 0) {
+
+        if(!entry->hasValue()) conffile.entryException(entry, "specify lod-threshold (pixels)");
+
+        lod_threshold = entry->getFloat();
+
+        if(lod_threshold < 0.0f) {
+            conffile.invalidValueException(entry);
+        }
+    }
+
     if((entry = gource_settings->getEntry("bloom-intensity")) != 0) {
 
         if(!entry->hasValue()) conffile.entryException(entry, "specify bloom-intensity (float)");
@@ -1066,6 +1136,14 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
         gStringHashSeed = entry->getInt();
     }
 
+    if((entry = gource_settings->getEntry("random-seed")) != 0) {
+
+        if(!entry->hasValue()) conffile.entryException(entry, "specify random seed (integer)");
+
+        random_seed   = entry->getInt();
+        deterministic = true;
+    }
+
     if((entry = gource_settings->getEntry("font-colour")) != 0) {
 
         if(!entry->hasValue()) conffile.entryException(entry, "specify font colour (FFFFFF)");
@@ -1268,6 +1346,10 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
         }
     }
 
+    if(gource_settings->getBool("catch-up")) {
+        catch_up = true;
+    }
+
     if((entry = gource_settings->getEntry("start-date")) != 0) {
 
         if(!entry->hasValue()) conffile.entryException(entry, "specify start-date (YYYY-MM-DD hh:mm:ss)");
@@ -1278,7 +1360,9 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
 
             char datestr[256];
             strftime(datestr, 256, "%Y-%m-%d", localtime ( &start_timestamp ));
-            start_date = datestr;
+
+            //generated logs need the earlier history to catch up from
+            if(!catch_up) start_date = datestr;
 
         } else {
             conffile.invalidValueException(entry);
@@ -1311,13 +1395,14 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
         }
     }
 
+    bool random_start_position = false;
+
     if((entry = gource_settings->getEntry("start-position")) != 0) {
 
         if(!entry->hasValue()) conffile.entryException(entry, "specify start-position (float,random)");
 
         if(entry->getString() == "random") {
-            srand(time(0));
-            start_position = (rand() % 1000) / 1000.0f;
+            random_start_position = true;
         } else {
             start_position = entry->getFloat();
 
@@ -1397,6 +1482,10 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
         }
     }
 
+    if(gource_settings->getBool("max-files-lru")) {
+        max_files_lru = true;
+    }
+
     if((entry = gource_settings->getEntry("max-file-lag")) != 0) {
 
         if(!entry->hasValue()) conffile.entryException(entry, "specify max-file-lag (seconds)");
@@ -1463,6 +1552,80 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
         }
     }
 
+    if((entry = gource_settings->getEntry("output-format")) != 0) {
+
+        if(!entry->hasValue()) conffile.entryException(entry, "specify output-format (ppm,y4m,i420,nv12)");
+
+        output_format = entry->getString();
+
+        if(output_format != "ppm" && output_format != "y4m" && output_format != "i420" && output_format != "nv12") {
+            conffile.invalidValueException(entry);
+        }
+    }
+
+    if((entry = gource_settings->getEntry("output-frame-range")) != 0) {
+
+        if(!entry->hasValue()) conffile.entryException(entry, "specify output-frame-range (START:END)");
+
+        std::string range = entry->getString();
+
+        size_t sep = range.find(':');
+
+        if(sep == std::string::npos || sep == 0
+            || range.find_first_not_of("0123456789:") != std::string::npos
+            || range.find(':', sep+1) != std::string::npos) {
+            conffile.invalidValueException(entry);
+        }
+
+        output_frame_start = atoi(range.substr(0, sep).c_str());
+
+        if(sep+1 < range.size()) {
+            output_frame_end = atoi(range.substr(sep+1).c_str());
+
+            if(output_frame_end <= output_frame_start) conffile.invalidValueException(entry);
+        }
+
+        //the frames either side of the range have to match a full render
+        deterministic = true;
+    }
+
+    //picked once deterministic is known, so every process of a split render starts at the same position
+    if(random_start_position) {
+        srand(deterministic ? random_seed : time(0));
+        start_position = (rand() % 1000) / 1000.0f;
+    }
+
+    if((entry = gource_settings->getEntry("output-tiles")) != 0) {
+
+        if(!entry->hasValue()) conffile.entryException(entry, "specify output-tiles (CxR)");
+
+        std::string tiles = entry->getString();
+
+        size_t sep = tiles.find('x');
+
+        if(sep == std::string::npos || sep == 0 || sep+1 == tiles.size()
+            || tiles.find_first_not_of("0123456789x") != std::string::npos
+            || tiles.find('x', sep+1) != std::string::npos) {
+            conffile.invalidValueException(entry);
+        }
+
+        output_tile_columns = atoi(tiles.substr(0, sep).c_str());
+        output_tile_rows    = atoi(tiles.substr(sep+1).c_str());
+
+        if(output_tile_columns < 1 || output_tile_rows < 1) conffile.invalidValueException(entry);
+    }
+
+    if((entry = gource_settings->getEntry("output-timecodes")) != 0) {
+
+        if(!entry->hasValue()) conffile.entryException(entry, "specify output-timecodes (file)");
+
+        if(output_frame_start > 0 || output_frame_end >= 0) {
+            conffile.entryException(entry, "output-timecodes cannot be used with output-frame-range");
+        }
+
+        output_timecodes_filename = entry->getString();
+    }
+
     if((entry = gource_settings->getEntry("padding")) != 0) {
 
         if(!entry->hasValue()) conffile.entryException(entry, "specify padding (float)");
@@ -1638,6 +1801,11 @@ void GourceSettings::importGourceSettings(ConfFile& conffile, ConfSection* gourc
             throw ConfFileException("log-format required when reading from STDIN", "", 0);
         }
 
+        //positions are a fraction of the log size, which STDIN doesn't have
+        if(catch_up && start_position > 0.0f) {
+            throw ConfFileException("catch-up with start-position can't be used when reading from STDIN", "", 0);
+        }
+
 #ifdef _WIN32
         DWORD available_bytes;
         HANDLE stdin_handle = GetStdHandle(STD_INPUT_HANDLE);
@@ -68,6 +68,7 @@ public:
     bool shutdown;
     bool stop_on_idle;
     bool stop_at_end;
+    bool catch_up;
     bool dont_stop;
     bool no_time_travel;
     bool fixed_user_size;
@@ -93,6 +94,15 @@ public:
     float camera_zoom_default;
 
     std::string camera_mode;
+    std::string output_format;
+    std::string output_timecodes_filename;
+    int output_frame_start;
+    int output_frame_end;
+    int output_tile_columns;
+    int output_tile_rows;
+
+    bool deterministic;
+    int random_seed;
     float padding;
 
     bool crop_vertical;
@@ -128,6 +138,7 @@ public:
     std::string date_format;
 
     int max_files;
+    bool max_files_lru;
     float max_user_speed;
     float max_file_lag;
 
@@ -164,11 +175,16 @@ public:
     vec3 filename_colour;
     float filename_time;
 
+    float lod_threshold;
+
     std::string output_custom_filename;
 
     TextureResource* file_graphic;
 
     int log_level;
+
+    bool benchmark;
+    bool offscreen;
     
     GourceSettings();
 
@@ -176,6 +192,8 @@ public:
 
     void setScaledFontSizes();
 
+    void setRecordingStopAtEnd();
+
     void importGourceSettings(ConfFile& conf, ConfSection* gource_settings = 0);
 
     void help(bool extended_help=false);
@@ -21,7 +21,7 @@ GourceShell* gGourceShell = 0;
 
 // GourceShell
 
-GourceShell::GourceShell(ConfFile* conf, FrameExporter* exporter) {
+GourceShell::GourceShell(ConfFile* conf, RFrameExporter* exporter) {
 
     this->conf     = conf;
     this->exporter = exporter;
@@ -39,6 +39,10 @@ GourceShell::GourceShell(ConfFile* conf, FrameExporter* exporter) {
     transition_texture = 0;
     transition_interval = 0.0f;
 
+    start_ticks  = SDL_GetPerformanceCounter();
+    frames_start = 0;
+    frames       = 0;
+
     if(GLEW_ARB_texture_non_power_of_two || GLEW_VERSION_2_0) {
         transition_texture = texturemanager.create(display.width, display.height, false, GL_CLAMP_TO_EDGE, GL_RGBA);
     }
@@ -217,12 +221,7 @@ Gource* GourceShell::getNext() {
 
     gGourceSettings.importGourceSettings(*conf, *gource_settings);
 
-    //recording a video kind of implies you want this, unless:
-    // -- dont stop requested
-    // -- loop requested
-    // -- reading from STDIN
-    if(exporter!=0 && !(gGourceSettings.dont_stop || gGourceSettings.loop || gGourceSettings.path == "-"))
-        gGourceSettings.stop_at_end = true;
+    if(exporter!=0) gGourceSettings.setRecordingStopAtEnd();
 
     //multiple repo special settings
     if(gGourceSettings.repo_count > 1) {
@@ -280,16 +279,35 @@ void GourceShell::blendLastFrame(float dt) {
     transition_interval -= dt;
 }
 
+void GourceShell::logTimings() {
+
+    if(frames_start == 0) return;
+
+    double freq = SDL_GetPerformanceFrequency();
+
+    double startup_time = (frames_start - start_ticks) / freq;
+    double frame_time   = (SDL_GetPerformanceCounter() - frames_start) / freq;
+
+    debugLog("window: startup %.1f ms, %d frames, %.2f ms/frame",
+        startup_time * 1000.0, frames, frames > 0 ? frame_time * 1000.0 / frames : 0.0);
+}
+
 void GourceShell::update(float t, float dt) {
 
     if(gource == 0 || gource->isFinished()) {
-        if(!getNext()) appFinished=true;
+        if(!getNext()) {
+            appFinished=true;
+            logTimings();
+        } else if(frames_start == 0) {
+            frames_start = SDL_GetPerformanceCounter();
+        }
 
         return;
     }
 
     gource->fps = this->fps;
     gource->update(t, dt);
+    frames++;
 
     if(toggle_delay > 0.0) toggle_delay -= dt;
 
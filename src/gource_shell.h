@@ -31,16 +31,24 @@ class GourceShell : public SDLApp {
     float transition_interval;
     float toggle_delay;
 
-    FrameExporter* exporter;
+    RFrameExporter* exporter;
     ConfFile* conf;
     ConfSectionList::iterator gource_settings;
 
+    //timings logged in the same form as --offscreen for comparison
+    Uint64 start_ticks;
+    Uint64 frames_start;
+    int frames;
+
     Gource* getNext();
     void blendLastFrame(float dt);
+    void logTimings();
 public:
-    GourceShell(ConfFile* conf, FrameExporter* exporter);
+    GourceShell(ConfFile* conf, RFrameExporter* exporter);
     ~GourceShell();
 
+    void setStartTicks(Uint64 ticks) { start_ticks = ticks; };
+
     void update(float t, float dt);
 
     void resize(int width, int height);
@@ -31,7 +31,7 @@ FileKeyEntry::FileKeyEntry(const FXFont& font, const std::string& ext, const vec
 
     bool truncated = false;
 
-    while(font.getWidth(display_ext) > width - 15.0f * gGourceSettings.font_scale) {
+    while(!gGourceSettings.benchmark && font.getWidth(display_ext) > width - 15.0f * gGourceSettings.font_scale) {
         display_ext.resize(display_ext.size()-1);
         truncated = true;
     }
@@ -163,9 +163,12 @@ FileKey::FileKey() {
 FileKey::FileKey(float update_interval) {
     this->update_interval = update_interval;
     interval_remaining = 1.0f;
-    font = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_font_size);
-    font.dropShadow(false);
-    font.roundCoordinates(false);
+
+    if(!gGourceSettings.benchmark) {
+        font = fontmanager.grab(gGourceSettings.font_file, gGourceSettings.scaled_font_size);
+        font.dropShadow(false);
+        font.roundCoordinates(false);
+    }
     show = true;
 }
 
@@ -209,7 +212,7 @@ void FileKey::clear() {
     interval_remaining = 0.0f;
 }
 
-void FileKey::inc(RFile* file) {
+void FileKey::inc(RFile* file, int count) {
 
     FileKeyEntry* entry = 0;
 
@@ -222,7 +225,7 @@ void FileKey::inc(RFile* file) {
         keymap[file->ext] = entry;
     }
 
-    entry->inc();
+    entry->setCount(entry->getCount() + count);
 }
 
 
@@ -90,7 +90,7 @@ public:
 
     void colourize();
     
-    void inc(RFile* file);
+    void inc(RFile* file, int count = 1);
     void dec(RFile* file);
 
     void logic(float dt);
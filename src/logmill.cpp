@@ -83,7 +83,8 @@ void RLogMill::run() {
         clog = fetchLog(log_format);
 
         // find first commit after start_timestamp if specified
-        if(clog != 0 && gGourceSettings.start_timestamp != 0) {
+        // (when catching up the earlier commits are applied by Gource)
+        if(clog != 0 && gGourceSettings.start_timestamp != 0 && !gGourceSettings.catch_up) {
 
             RCommit commit;
 
@@ -127,6 +127,55 @@ int main(int argc, char *argv[]) {
         SDLAppQuit(exception.what());
     }
 
+    //simulate the log without a display and report timings
+    if(gGourceSettings.benchmark) {
+
+        try {
+            GourceBenchmark benchmark;
+            benchmark.run();
+
+        } catch(SDLAppException& exception) {
+
+            if(exception.showHelp()) {
+                gGourceSettings.help();
+            } else {
+                SDLAppQuit(exception.what());
+            }
+        }
+
+        return 0;
+    }
+
+    //render the output without a window
+    if(gGourceSettings.offscreen) {
+
+        if(gGourceSettings.output_ppm_filename.empty()) {
+            SDLAppQuit("--offscreen requires --output-ppm-stream");
+        }
+
+        try {
+            GourceOffscreen offscreen;
+            offscreen.run();
+
+        } catch(ResourceException& exception) {
+
+            char errormsg[1024];
+            snprintf(errormsg, 1024, "failed to load resource '%s'", exception.what());
+
+            SDLAppQuit(errormsg);
+
+        } catch(SDLAppException& exception) {
+
+            if(exception.showHelp()) {
+                gGourceSettings.help();
+            } else {
+                SDLAppQuit(exception.what());
+            }
+        }
+
+        return 0;
+    }
+
     //enable frameless
     display.enableFrameless(gGourceSettings.frameless);
 
@@ -162,6 +211,8 @@ int main(int argc, char *argv[]) {
 #endif
     display.enableHighDPIAwareness(high_dpi);
 
+    Uint64 startup_ticks = SDL_GetPerformanceCounter();
+
     try {
 
         display.init("Gource", gGourceSettings.display_width, gGourceSettings.display_height, gGourceSettings.fullscreen, gGourceSettings.screen);
@@ -183,13 +234,13 @@ int main(int argc, char *argv[]) {
     }
 
     //init frame exporter
-    FrameExporter* exporter = 0;
+    RFrameExporter* exporter = 0;
 
     if(gGourceSettings.output_ppm_filename.size() > 0) {
 
         try {
 
-            exporter = new PPMExporter(gGourceSettings.output_ppm_filename);
+            exporter = createFrameExporter(gGourceSettings.output_format, gGourceSettings.output_ppm_filename, gGourceSettings.output_framerate, gGourceSettings.output_timecodes_filename, gGourceSettings.output_frame_start == 0);
 
         } catch(PPMExporterException& exception) {
 
@@ -208,6 +259,7 @@ int main(int argc, char *argv[]) {
 
     try {
         gourcesh = gGourceShell = new GourceShell(&conf, exporter);
+        gourcesh->setStartTicks(startup_ticks);
         gourcesh->run();
 
     } catch(ResourceException& exception) {
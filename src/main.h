@@ -19,6 +19,8 @@
 #define GOURCE_MAIN_H
 
 #include "gource_shell.h"
+#include "benchmark.h"
+#include "offscreen.h"
 #include "gource.h"
 
 #endif
@@ -0,0 +1,255 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "offscreen.h"
+
+#include <string.h>
+#include <stdio.h>
+
+GourceOffscreen::GourceOffscreen() {
+#ifdef HAVE_EGL
+    egl_display = EGL_NO_DISPLAY;
+    egl_context = EGL_NO_CONTEXT;
+    egl_surface = EGL_NO_SURFACE;
+#endif
+
+    framebuffer = colour_buffer = depth_buffer = 0;
+
+    startup_time = frame_time = 0.0;
+    frames = 0;
+}
+
+GourceOffscreen::~GourceOffscreen() {
+    quit();
+}
+
+#ifdef HAVE_EGL
+
+static bool hasEGLExtension(const char* extensions, const char* name) {
+    if(extensions == 0) return false;
+
+    size_t len = strlen(name);
+
+    for(const char* p = strstr(extensions, name); p != 0; p = strstr(p + len, name)) {
+        if((p == extensions || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0')) return true;
+    }
+
+    return false;
+}
+
+void GourceOffscreen::initContext() {
+
+    //prefer Mesa's surfaceless platform which needs no display server or GPU
+    const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    if(hasEGLExtension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+        if(getPlatformDisplay != 0) {
+            egl_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+        }
+    }
+#endif
+
+    if(egl_display == EGL_NO_DISPLAY) {
+        egl_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if(egl_display == EGL_NO_DISPLAY || !eglInitialize(egl_display, 0, 0)) {
+        throw SDLAppException("offscreen rendering failed - could not initialize EGL");
+    }
+
+    if(!eglBindAPI(EGL_OPENGL_API)) {
+        throw SDLAppException("offscreen rendering failed - EGL does not support OpenGL");
+    }
+
+    EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE,   8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE,  8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint config_count = 0;
+
+    if(!eglChooseConfig(egl_display, config_attribs, &config, 1, &config_count) || config_count == 0) {
+        throw SDLAppException("offscreen rendering failed - no suitable EGL config");
+    }
+
+    //compatibility context as drawing still uses the fixed function pipeline
+    egl_context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, 0);
+
+    if(egl_context == EGL_NO_CONTEXT) {
+        throw SDLAppException("offscreen rendering failed - could not create an OpenGL context");
+    }
+
+    //everything is drawn to a framebuffer object, a surface is only needed
+    //to make the context current if surfaceless contexts aren't supported
+    if(!hasEGLExtension(eglQueryString(egl_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+
+        EGLint pbuffer_attribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+
+        egl_surface = eglCreatePbufferSurface(egl_display, config, pbuffer_attribs);
+
+        if(egl_surface == EGL_NO_SURFACE) {
+            throw SDLAppException("offscreen rendering failed - could not create a pbuffer surface");
+        }
+    }
+
+    if(!eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context)) {
+        throw SDLAppException("offscreen rendering failed - could not make the OpenGL context current");
+    }
+
+    GLenum glew_status = glewInit();
+
+    //GLEW built for GLX reports a missing X display after loading the GL entry points
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if(glew_status == GLEW_ERROR_NO_GLX_DISPLAY) glew_status = GLEW_OK;
+#endif
+
+    if(glew_status != GLEW_OK) {
+        char errormsg[1024];
+        snprintf(errormsg, 1024, "offscreen rendering failed - %s", (const char*) glewGetErrorString(glew_status));
+
+        throw SDLAppException(errormsg);
+    }
+}
+
+void GourceOffscreen::quit() {
+
+    if(framebuffer != 0) {
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+        glDeleteFramebuffersEXT(1, &framebuffer);
+        glDeleteRenderbuffersEXT(1, &colour_buffer);
+        glDeleteRenderbuffersEXT(1, &depth_buffer);
+        framebuffer = colour_buffer = depth_buffer = 0;
+    }
+
+    if(egl_display == EGL_NO_DISPLAY) return;
+
+    eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if(egl_surface != EGL_NO_SURFACE) eglDestroySurface(egl_display, egl_surface);
+    if(egl_context != EGL_NO_CONTEXT) eglDestroyContext(egl_display, egl_context);
+
+    eglTerminate(egl_display);
+
+    egl_display = EGL_NO_DISPLAY;
+    egl_context = EGL_NO_CONTEXT;
+    egl_surface = EGL_NO_SURFACE;
+}
+
+#else
+
+void GourceOffscreen::initContext() {
+    throw SDLAppException("offscreen rendering requires gource to be built with EGL");
+}
+
+void GourceOffscreen::quit() {
+}
+
+#endif
+
+void GourceOffscreen::initFramebuffer() {
+
+    if(!GLEW_EXT_framebuffer_object) {
+        throw SDLAppException("offscreen rendering failed - framebuffer objects are not supported");
+    }
+
+    glGenFramebuffersEXT(1, &framebuffer);
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, framebuffer);
+
+    glGenRenderbuffersEXT(1, &colour_buffer);
+    glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, colour_buffer);
+    glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_RGBA8, display.width, display.height);
+    glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_RENDERBUFFER_EXT, colour_buffer);
+
+    glGenRenderbuffersEXT(1, &depth_buffer);
+    glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, depth_buffer);
+    glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT24, display.width, display.height);
+    glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, depth_buffer);
+
+    if(glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT) {
+        throw SDLAppException("offscreen rendering failed - incomplete framebuffer");
+    }
+
+    //frames are read back from the framebuffer object
+    glDrawBuffer(GL_COLOR_ATTACHMENT0_EXT);
+    glReadBuffer(GL_COLOR_ATTACHMENT0_EXT);
+
+    glViewport(0, 0, display.width, display.height);
+}
+
+void GourceOffscreen::run() {
+
+    Uint64 freq  = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    display.width  = gGourceSettings.display_width  > 0 ? gGourceSettings.display_width  : 1024;
+    display.height = gGourceSettings.display_height > 0 ? gGourceSettings.display_height : 768;
+
+    gGourceSettings.repo_count = 1;
+    gGourceSettings.hide_mouse = true;
+    gGourceSettings.loop       = false;
+
+    initContext();
+    initFramebuffer();
+
+    RFrameExporter* exporter = 0;
+
+    try {
+        exporter = createFrameExporter(gGourceSettings.output_format, gGourceSettings.output_ppm_filename, gGourceSettings.output_framerate, gGourceSettings.output_timecodes_filename, gGourceSettings.output_frame_start == 0);
+    } catch(PPMExporterException& exception) {
+        char errormsg[1024];
+        snprintf(errormsg, 1024, "could not write to '%s'", exception.what());
+
+        throw SDLAppException(errormsg);
+    }
+
+    gGourceSettings.setRecordingStopAtEnd();
+
+    Gource* gource = new Gource(exporter);
+
+    startup_time = (SDL_GetPerformanceCounter() - start) / (double) freq;
+
+    //the exporter fixes the time step to the output framerate
+    float dt = 1.0f / gGourceSettings.output_framerate;
+    float t  = 0.0f;
+
+    Uint64 frames_start = SDL_GetPerformanceCounter();
+
+    while(!gource->isFinished() && !gGourceSettings.shutdown) {
+        gource->update(t, dt);
+        t += dt;
+        frames++;
+    }
+
+    frame_time = (SDL_GetPerformanceCounter() - frames_start) / (double) freq;
+
+    debugLog("offscreen: startup %.1f ms, %d frames, %.2f ms/frame",
+        startup_time * 1000.0, frames, frames > 0 ? frame_time * 1000.0 / frames : 0.0);
+
+    delete gource;
+    delete exporter;
+
+    quit();
+}
@@ -0,0 +1,57 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GOURCE_OFFSCREEN_H
+#define GOURCE_OFFSCREEN_H
+
+#include "gource.h"
+
+#ifdef HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// Renders into a framebuffer object of an EGL context with no window, so
+// videos can be exported on machines without a display server (including
+// with Mesa's software rasterizer), and writes each frame to the PPM stream.
+
+class GourceOffscreen {
+#ifdef HAVE_EGL
+    EGLDisplay egl_display;
+    EGLContext egl_context;
+    EGLSurface egl_surface;
+#endif
+
+    GLuint framebuffer;
+    GLuint colour_buffer;
+    GLuint depth_buffer;
+
+    double startup_time;
+    double frame_time;
+    int frames;
+
+    void initContext();
+    void initFramebuffer();
+    void quit();
+public:
+    GourceOffscreen();
+    ~GourceOffscreen();
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,308 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pathtrie.h"
+
+RPathTrie gGourceDirTrie;
+
+RPathTrieNode::RPathTrieNode(int parent, int component)
+    : parent(parent), component(component), first_child(-1), next_sibling(-1), prev_sibling(-1), dir_count(0), dir(0), dir_index(-1) {
+}
+
+RPathTrie::RPathTrie() {
+    clear();
+}
+
+void RPathTrie::clear() {
+    nodes.clear();
+    free_nodes.clear();
+    components.clear();
+    edges.clear();
+    dirs.clear();
+    dir_nodes.clear();
+
+    //root node ('/')
+    nodes.push_back(RPathTrieNode(-1, -1));
+}
+
+uint64_t RPathTrie::edgeKey(int parent, int component) {
+    return ((uint64_t) parent << 32) | (uint32_t) component;
+}
+
+//get the next non-empty component of path starting from offset
+bool RPathTrie::nextComponent(const std::string& path, size_t& offset, std::string& component) {
+
+    while(offset < path.size() && path[offset] == '/') offset++;
+
+    if(offset >= path.size()) return false;
+
+    size_t end = path.find('/', offset);
+    if(end == std::string::npos) end = path.size();
+
+    component.assign(path, offset, end - offset);
+    offset = end;
+
+    return true;
+}
+
+int RPathTrie::findComponent(const std::string& name) const {
+    std::unordered_map<std::string, int>::const_iterator it = components.find(name);
+
+    if(it == components.end()) return -1;
+
+    return it->second;
+}
+
+int RPathTrie::internComponent(const std::string& name) {
+    std::unordered_map<std::string, int>::iterator it = components.find(name);
+
+    if(it != components.end()) return it->second;
+
+    int id = components.size();
+    components[name] = id;
+
+    return id;
+}
+
+int RPathTrie::findChild(int parent, int component) const {
+    std::unordered_map<uint64_t, int>::const_iterator it = edges.find(edgeKey(parent, component));
+
+    if(it == edges.end()) return -1;
+
+    return it->second;
+}
+
+int RPathTrie::addChild(int parent, int component) {
+
+    int node;
+
+    if(!free_nodes.empty()) {
+        node = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[node] = RPathTrieNode(parent, component);
+    } else {
+        node = nodes.size();
+        nodes.push_back(RPathTrieNode(parent, component));
+    }
+
+    int sibling = nodes[parent].first_child;
+
+    nodes[node].next_sibling = sibling;
+    if(sibling != -1) nodes[sibling].prev_sibling = node;
+    nodes[parent].first_child = node;
+
+    edges[edgeKey(parent, component)] = node;
+
+    return node;
+}
+
+void RPathTrie::removeNode(int node) {
+    RPathTrieNode& n = nodes[node];
+
+    if(n.prev_sibling != -1) {
+        nodes[n.prev_sibling].next_sibling = n.next_sibling;
+    } else {
+        nodes[n.parent].first_child = n.next_sibling;
+    }
+
+    if(n.next_sibling != -1) nodes[n.next_sibling].prev_sibling = n.prev_sibling;
+
+    edges.erase(edgeKey(n.parent, n.component));
+
+    n = RPathTrieNode(-1, -1);
+
+    free_nodes.push_back(node);
+}
+
+int RPathTrie::findNode(const std::string& path) const {
+
+    std::string name;
+    size_t offset = 0;
+    int node = 0;
+
+    while(nextComponent(path, offset, name)) {
+        int component = findComponent(name);
+        if(component == -1) return -1;
+
+        node = findChild(node, component);
+        if(node == -1) return -1;
+    }
+
+    return node;
+}
+
+void RPathTrie::add(const std::string& path, RDirNode* dir) {
+
+    std::string name;
+    size_t offset = 0;
+    int node = 0;
+
+    while(nextComponent(path, offset, name)) {
+        int component = internComponent(name);
+
+        int child = findChild(node, component);
+        if(child == -1) child = addChild(node, component);
+
+        node = child;
+    }
+
+    //replace existing entry
+    if(nodes[node].dir != 0) {
+        nodes[node].dir = dir;
+        dirs[nodes[node].dir_index] = dir;
+        return;
+    }
+
+    nodes[node].dir       = dir;
+    nodes[node].dir_index = dirs.size();
+
+    dirs.push_back(dir);
+    dir_nodes.push_back(node);
+
+    for(int n = node; n != -1; n = nodes[n].parent) {
+        nodes[n].dir_count++;
+    }
+}
+
+void RPathTrie::remove(const std::string& path) {
+
+    int node = findNode(path);
+
+    if(node == -1 || nodes[node].dir == 0) return;
+
+    //swap last dir into the removed slot
+    int index = nodes[node].dir_index;
+    int last  = dirs.size() - 1;
+
+    if(index != last) {
+        dirs[index]      = dirs[last];
+        dir_nodes[index] = dir_nodes[last];
+        nodes[dir_nodes[index]].dir_index = index;
+    }
+
+    dirs.pop_back();
+    dir_nodes.pop_back();
+
+    nodes[node].dir       = 0;
+    nodes[node].dir_index = -1;
+
+    for(int n = node; n != -1; n = nodes[n].parent) {
+        nodes[n].dir_count--;
+    }
+
+    //prune branches with no directories left under them
+    while(node != 0 && nodes[node].dir_count == 0) {
+        int parent = nodes[node].parent;
+        removeNode(node);
+        node = parent;
+    }
+}
+
+RDirNode* RPathTrie::find(const std::string& path) const {
+    int node = findNode(path);
+
+    if(node == -1) return 0;
+
+    return nodes[node].dir;
+}
+
+//find the deepest directory that is a prefix of path
+RDirNode* RPathTrie::findClosest(const std::string& path) const {
+
+    std::string name;
+    size_t offset = 0;
+    int node = 0;
+
+    RDirNode* closest = nodes[0].dir;
+
+    while(nextComponent(path, offset, name)) {
+        int component = findComponent(name);
+        if(component == -1) break;
+
+        node = findChild(node, component);
+        if(node == -1) break;
+
+        if(nodes[node].dir != 0) closest = nodes[node].dir;
+    }
+
+    return closest;
+}
+
+//true if there is a directory at or below path
+bool RPathTrie::isDir(const std::string& path) const {
+    int node = findNode(path);
+
+    return node != -1 && nodes[node].dir_count > 0;
+}
+
+void RPathTrie::findDirs(int node, std::list<RDirNode*>& found) const {
+
+    if(nodes[node].dir_count == 0) return;
+
+    if(nodes[node].dir != 0) {
+        found.push_back(nodes[node].dir);
+        return;
+    }
+
+    for(int child = nodes[node].first_child; child != -1; child = nodes[child].next_sibling) {
+        findDirs(child, found);
+    }
+}
+
+//finds directories closest to the root directory prefixed by path (eg foo/ may match just foo/ or could also match foo/bar1, foo/bar2, ... if foo/ doesn't exist).
+void RPathTrie::findDirs(const std::string& path, std::list<RDirNode*>& found) const {
+    int node = findNode(path);
+
+    if(node == -1) return;
+
+    findDirs(node, found);
+}
+
+//longest prefix of path (ending in a slash) that has directories at or below it
+std::string RPathTrie::commonPrefix(const std::string& path) const {
+
+    if(nodes[0].dir_count == 0) return "";
+
+    std::string name;
+    size_t offset  = 0;
+    size_t matched = 0;
+    int node = 0;
+
+    while(nextComponent(path, offset, name)) {
+        int component = findComponent(name);
+        if(component == -1) break;
+
+        node = findChild(node, component);
+        if(node == -1) break;
+
+        matched = offset;
+    }
+
+    if(matched == 0) return "/";
+
+    if(matched < path.size()) return path.substr(0, matched+1);
+
+    return path + std::string("/");
+}
+
+size_t RPathTrie::size() const {
+    return dirs.size();
+}
+
+RDirNode* RPathTrie::getDir(size_t i) const {
+    return dirs[i];
+}
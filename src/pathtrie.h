@@ -0,0 +1,96 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RPATHTRIE_H
+#define RPATHTRIE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <stdint.h>
+
+class RDirNode;
+
+// Index of directory nodes by path. Paths are split into components
+// which are interned to ids, and each trie node is found from its parent
+// by hashing (parent, component) so lookups are O(depth).
+
+class RPathTrieNode {
+public:
+    int parent;
+    int component;
+
+    int first_child;
+    int next_sibling;
+    int prev_sibling;
+
+    // number of directories at or below this node
+    int dir_count;
+
+    RDirNode* dir;
+    int dir_index;
+
+    RPathTrieNode(int parent, int component);
+};
+
+class RPathTrie {
+    std::vector<RPathTrieNode> nodes;
+    std::vector<int> free_nodes;
+
+    std::unordered_map<std::string, int> components;
+    std::unordered_map<uint64_t, int> edges;
+
+    std::vector<RDirNode*> dirs;
+    std::vector<int> dir_nodes;
+
+    static uint64_t edgeKey(int parent, int component);
+    static bool nextComponent(const std::string& path, size_t& offset, std::string& component);
+
+    int findComponent(const std::string& name) const;
+    int internComponent(const std::string& name);
+
+    int findChild(int parent, int component) const;
+    int addChild(int parent, int component);
+    void removeNode(int node);
+
+    int findNode(const std::string& path) const;
+
+    void findDirs(int node, std::list<RDirNode*>& found) const;
+public:
+    RPathTrie();
+
+    void clear();
+
+    void add(const std::string& path, RDirNode* dir);
+    void remove(const std::string& path);
+
+    RDirNode* find(const std::string& path) const;
+    RDirNode* findClosest(const std::string& path) const;
+
+    bool isDir(const std::string& path) const;
+    void findDirs(const std::string& path, std::list<RDirNode*>& found) const;
+
+    std::string commonPrefix(const std::string& path) const;
+
+    size_t size() const;
+    RDirNode* getDir(size_t i) const;
+};
+
+extern RPathTrie gGourceDirTrie;
+
+#endif
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pool.h"
+
+#include <new>
+#include <algorithm>
+
+#ifdef GOURCE_ALLOCATION_STATS
+#include <atomic>
+#include <stdlib.h>
+
+static std::atomic<size_t> gHeapAllocations(0);
+
+void* operator new(size_t size) {
+    gHeapAllocations++;
+
+    void* ptr = malloc(size > 0 ? size : 1);
+
+    if(ptr == 0) throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+size_t RObjectPool::heapAllocationCount() {
+    return gHeapAllocations;
+}
+#endif
+
+RObjectPool::RObjectPool(size_t object_size, size_t slab_size) : slab_size(slab_size) {
+
+    //keep objects aligned and big enough to hold the free list pointer
+    size_t align = sizeof(void*) * 2;
+
+    this->object_size = ((std::max(object_size, sizeof(void*)) + align - 1) / align) * align;
+
+    free_list = 0;
+    in_use    = 0;
+
+#ifdef GOURCE_ALLOCATION_STATS
+    allocations = 0;
+#endif
+}
+
+RObjectPool::~RObjectPool() {
+    for(std::vector<char*>::iterator it = slabs.begin(); it != slabs.end(); it++) {
+        delete[] (*it);
+    }
+}
+
+void RObjectPool::addSlab() {
+    char* slab = new char[object_size * slab_size];
+
+    slabs.push_back(slab);
+
+    //thread new objects onto the free list
+    for(size_t i = slab_size; i > 0; i--) {
+        void* object = slab + (i-1) * object_size;
+
+        *((void**)object) = free_list;
+        free_list = object;
+    }
+}
+
+void* RObjectPool::allocate(size_t size) {
+
+    //derived class larger than the pool was sized for
+    if(size > object_size) throw std::bad_alloc();
+
+    if(free_list == 0) addSlab();
+
+    void* object = free_list;
+    free_list = *((void**)object);
+
+    in_use++;
+
+#ifdef GOURCE_ALLOCATION_STATS
+    allocations++;
+#endif
+
+    return object;
+}
+
+void RObjectPool::release(void* object) {
+    if(object == 0) return;
+
+    *((void**)object) = free_list;
+    free_list = object;
+
+    in_use--;
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RPOOL_H
+#define RPOOL_H
+
+#include <vector>
+#include <stddef.h>
+
+// Fixed size object pool. Memory is allocated in slabs and freed objects
+// are kept on a free list for reuse, so the heap is only touched when the
+// pool has to grow. Used via class specific operator new / delete.
+//
+// Building with GOURCE_ALLOCATION_STATS defined counts pool hand-outs and
+// replaces the global operator new to count every heap allocation made
+// outside the pools.
+
+class RObjectPool {
+    size_t object_size;
+    size_t slab_size;
+
+    std::vector<char*> slabs;
+
+    void* free_list;
+
+    size_t in_use;
+
+#ifdef GOURCE_ALLOCATION_STATS
+    size_t allocations;
+#endif
+
+    void addSlab();
+public:
+    RObjectPool(size_t object_size, size_t slab_size = 1024);
+    ~RObjectPool();
+
+    void* allocate(size_t size);
+    void release(void* object);
+
+    size_t objectsInUse() const  { return in_use; };
+    size_t capacity() const      { return slabs.size() * slab_size; };
+    size_t slabCount() const     { return slabs.size(); };
+
+#ifdef GOURCE_ALLOCATION_STATS
+    size_t allocationCount() const { return allocations; };
+
+    // calls to the global operator new
+    static size_t heapAllocationCount();
+#endif
+};
+
+#endif
@@ -17,13 +17,38 @@
 
 #include "spline.h"
 
+//how far an end point (in pixels) or colour has to move before the spline is regenerated
+float gGourceSplinePosEpsilon    = 0.1f;
+float gGourceSplineColourEpsilon = 1.0f / 255.0f;
+
 SplineEdge::SplineEdge() {
+    point_count = 0;
+}
+
+static inline bool splineMoved(const vec2& a, const vec2& b) {
+    return glm::abs(a.x - b.x) > gGourceSplinePosEpsilon || glm::abs(a.y - b.y) > gGourceSplinePosEpsilon;
+}
+
+static inline bool splineRecoloured(const vec4& a, const vec4& b) {
+    vec4 d = glm::abs(a - b);
+    return std::max(std::max(d.x, d.y), std::max(d.z, d.w)) > gGourceSplineColourEpsilon;
+}
+
+bool SplineEdge::changed(const vec2& pos1, const vec4& col1, const vec2& pos2, const vec4& col2, const vec2& spos) const {
+    return point_count == 0
+        || splineMoved(pos1, last_pos1) || splineMoved(pos2, last_pos2) || splineMoved(spos, last_spos)
+        || splineRecoloured(col1, last_col1) || splineRecoloured(col2, last_col2);
 }
 
 void SplineEdge::update(const vec2& pos1, const vec4& col1, const vec2& pos2, const vec4& col2, const vec2& spos) {
 
-    vec2 pt_last;
-    vec4 col_last;
+    if(!changed(pos1, col1, pos2, col2, spos)) return;
+
+    last_pos1 = pos1;
+    last_pos2 = pos2;
+    last_spos = spos;
+    last_col1 = col1;
+    last_col2 = col2;
 
     vec2 mid = (pos1 - pos2) * 0.5f;
     vec2 to  = vec2(pos1 - spos);
@@ -34,15 +59,11 @@ void SplineEdge::update(const vec2& pos1, const vec4& col1, const vec2& pos2, co
 
     float ang = acos(dp) / PI;
 
-    int edge_detail = std::min(10, (int) (ang * 100.0));
+    int edge_detail = std::min(SPLINE_EDGE_MAX_POINTS-1, (int) (ang * 100.0));
 
     if(edge_detail<1) edge_detail = 1;
 
-    spline_point.clear();
-    spline_colour.clear();
-
-    spline_point.reserve(edge_detail+1);
-    spline_colour.reserve(edge_detail+1);
+    point_count = edge_detail+1;
 
     //calculate positions
     for(int i=0; i <= edge_detail; i++) {
@@ -56,8 +77,8 @@ void SplineEdge::update(const vec2& pos1, const vec4& col1, const vec2& pos2, co
 
         vec4 coln = col1 * t + col2 * tt;
 
-        spline_point.push_back(pt);
-        spline_colour.push_back(coln);
+        spline_point[i]  = pt;
+        spline_colour[i] = coln;
     }
 
     const float pos = gGourceSettings.dir_name_position;
@@ -74,7 +95,7 @@ const vec2& SplineEdge::getLabelPos() const {
 
 void SplineEdge::drawToVBO(quadbuf& buffer) const {
 
-    int edges_count = spline_point.size() - 1;
+    int edges_count = point_count - 1;
 
     for(int i=0; i < edges_count; i++) {
 
@@ -119,7 +140,7 @@ void SplineEdge::drawBeam(const vec2 & pos1, const vec4 & col1, const vec2 & pos
 
 void SplineEdge::drawShadow() const{
 
-    int edges_count = spline_point.size() - 1;
+    int edges_count = point_count - 1;
 
     vec2 offset(2.0, 2.0);
 
@@ -134,7 +155,7 @@ void SplineEdge::drawShadow() const{
 
 void SplineEdge::draw() const{
 
-    int edges_count = spline_point.size() - 1;
+    int edges_count = point_count - 1;
 
     glBegin(GL_QUAD_STRIP);
 
@@ -26,13 +26,25 @@
 
 #include <vector>
 
+#define SPLINE_EDGE_MAX_POINTS 11
+
+extern float gGourceSplinePosEpsilon;
+extern float gGourceSplineColourEpsilon;
+
 class SplineEdge {
 
-    std::vector<vec2> spline_point;
-    std::vector<vec4> spline_colour;
+    vec2 spline_point[SPLINE_EDGE_MAX_POINTS];
+    vec4 spline_colour[SPLINE_EDGE_MAX_POINTS];
+    int  point_count;
 
     vec2 label_pos;
-    
+
+    //inputs the points were last generated from
+    vec2 last_pos1, last_pos2, last_spos;
+    vec4 last_col1, last_col2;
+
+    bool changed(const vec2& pos1, const vec4& col1, const vec2& pos2, const vec4& col2, const vec2& spos) const;
+
     void drawBeam(const vec2 & pos1, const vec4 & col1, const vec2 & pos2, const vec4 & col2, float radius, bool first) const;
 public:
     SplineEdge();
@@ -0,0 +1,190 @@
+/*
+    Copyright (C) 2011 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sprites.h"
+
+#include <string.h>
+
+GLuint packColour(const vec4& colour) {
+    GLubyte bytes[4];
+
+    for(int i = 0; i < 4; i++) {
+        bytes[i] = (GLubyte) (glm::clamp(colour[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    GLuint packed;
+    memcpy(&packed, bytes, 4);
+
+    return packed;
+}
+
+//RInstancedQuad
+
+RInstancedQuad::RInstancedQuad() {
+    quadid = 0;
+}
+
+RInstancedQuad::~RInstancedQuad() {
+    unload();
+}
+
+bool RInstancedQuad::supported() {
+    return GLEW_VERSION_2_0 && GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
+}
+
+GLint RInstancedQuad::attribute(const char* name) {
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+    if(program == 0) return -1;
+
+    return glGetAttribLocation(program, name);
+}
+
+void RInstancedQuad::unload() {
+    if(quadid != 0) glDeleteBuffers(1, &quadid);
+    quadid = 0;
+}
+
+void RInstancedQuad::bind() {
+
+    if(quadid == 0) {
+        GLfloat corners[8] = { 0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f };
+
+        glGenBuffers(1, &quadid);
+        glBindBuffer(GL_ARRAY_BUFFER, quadid);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, quadid);
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RInstancedQuad::draw(int instances) {
+    glDrawArraysInstancedARB(GL_TRIANGLE_FAN, 0, 4, instances);
+}
+
+void RInstancedQuad::unbind() {
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+//spritebuf
+
+spritebuf::spritebuf() {
+    buffer_offset = 0;
+    quads = 0;
+}
+
+void spritebuf::unload() {
+    buffer.unload();
+    quad.unload();
+    buffer_offset = 0;
+}
+
+void spritebuf::reset() {
+    instances.clear();
+    batches.clear();
+
+    if(quads != 0) quads->reset();
+}
+
+void spritebuf::setQuads(quadbuf* quads) {
+    this->quads = quads;
+}
+
+size_t spritebuf::sprites() {
+    return instances.size();
+}
+
+size_t spritebuf::capacity() {
+    return instances.capacity();
+}
+
+int spritebuf::texture_changes() {
+    return batches.size();
+}
+
+void spritebuf::add(GLuint textureid, const vec2& pos, const vec2& dims, const vec4& colour) {
+
+    if(quads != 0) {
+        quads->add(textureid, pos, dims, colour);
+        return;
+    }
+
+    if(batches.empty() || batches.back().textureid != textureid) {
+        batches.push_back(sprite_batch(textureid, instances.size()));
+    }
+
+    instances.push_back(sprite_instance(pos, dims, packColour(colour)));
+    batches.back().count++;
+}
+
+void spritebuf::update() {
+    if(quads != 0) {
+        quads->update();
+        return;
+    }
+
+    if(instances.empty()) return;
+
+    buffer_offset = buffer.upload(&(instances[0]), instances.size() * sizeof(sprite_instance));
+}
+
+void spritebuf::draw() {
+    if(instances.empty()) return;
+
+    GLint rect_attrib   = RInstancedQuad::attribute("sprite_rect");
+    GLint colour_attrib = RInstancedQuad::attribute("sprite_colour");
+
+    if(rect_attrib < 0 || colour_attrib < 0) return;
+
+    quad.bind();
+
+    buffer.bind();
+
+    glEnableVertexAttribArray(rect_attrib);
+    glEnableVertexAttribArray(colour_attrib);
+
+    glVertexAttribDivisorARB(rect_attrib,   1);
+    glVertexAttribDivisorARB(colour_attrib, 1);
+
+    for(std::vector<sprite_batch>::iterator it = batches.begin(); it != batches.end(); it++) {
+
+        glBindTexture(GL_TEXTURE_2D, it->textureid);
+
+        size_t offset = buffer_offset + it->start * sizeof(sprite_instance);
+
+        glVertexAttribPointer(rect_attrib,   4, GL_FLOAT,         GL_FALSE, sizeof(sprite_instance), (GLvoid*)(offset));
+        glVertexAttribPointer(colour_attrib, 4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(sprite_instance), (GLvoid*)(offset+16)); // offset pos + dims (4x4 bytes)
+
+        quad.draw(it->count);
+    }
+
+    glVertexAttribDivisorARB(rect_attrib,   0);
+    glVertexAttribDivisorARB(colour_attrib, 0);
+
+    glDisableVertexAttribArray(rect_attrib);
+    glDisableVertexAttribArray(colour_attrib);
+
+    buffer.unbind();
+
+    quad.unbind();
+}
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2011 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GOURCE_SPRITES_H
+#define GOURCE_SPRITES_H
+
+#include <vector>
+
+#include "core/display.h"
+#include "core/vectors.h"
+#include "core/vbo.h"
+
+#include "streambuffer.h"
+
+// pack a colour as normalized RGBA bytes
+GLuint packColour(const vec4& colour);
+
+// A unit quad from (0,0) to (1,1) drawn once per instance. The current
+// shader places each instance using attributes read from an instance buffer.
+
+class RInstancedQuad {
+    GLuint quadid;
+public:
+    RInstancedQuad();
+    ~RInstancedQuad();
+
+    static bool supported();
+
+    // location of an attribute of the current shader program
+    static GLint attribute(const char* name);
+
+    void unload();
+
+    void bind();
+    void draw(int instances);
+    void unbind();
+};
+
+// one record per sprite, expanded to a quad by the sprite shader (20 bytes)
+class sprite_instance {
+public:
+    sprite_instance() {};
+    sprite_instance(const vec2& pos, const vec2& dims, GLuint colour) :
+        pos(pos), dims(dims), colour(colour) {};
+
+    vec2 pos;
+    vec2 dims;
+    GLuint colour;
+};
+
+class sprite_batch {
+public:
+    sprite_batch(GLuint textureid, int start) :
+        textureid(textureid), start(start), count(0) {};
+
+    GLuint textureid;
+    int start;
+    int count;
+};
+
+// Textured sprites drawn as instances of one quad, batched by texture.
+// Where instancing is not available the sprites are written straight to
+// a quadbuf set with setQuads() and drawn from that instead.
+
+class spritebuf {
+    std::vector<sprite_instance> instances;
+    std::vector<sprite_batch> batches;
+
+    RStreamBuffer buffer;
+    size_t buffer_offset;
+
+    RInstancedQuad quad;
+
+    quadbuf* quads;
+public:
+    spritebuf();
+
+    void unload();
+    void reset();
+
+    size_t sprites();
+    size_t capacity();
+    int texture_changes();
+
+    void setQuads(quadbuf* quads);
+
+    void add(GLuint textureid, const vec2& pos, const vec2& dims, const vec4& colour);
+
+    void update();
+
+    // draw with a shader taking sprite_rect and sprite_colour attributes
+    void draw();
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2011 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "streambuffer.h"
+
+#include "core/logger.h"
+
+#include <string.h>
+#include <algorithm>
+
+//RStreamBuffer
+
+RStreamBuffer::RStreamBuffer(GLenum target, int region_count) : target(target), region_count(region_count) {
+    bufferid    = 0;
+    region_size = 0;
+    region      = 0;
+    pending     = false;
+    persistent  = false;
+    mapped      = 0;
+}
+
+RStreamBuffer::~RStreamBuffer() {
+    unload();
+}
+
+void RStreamBuffer::unload() {
+
+#ifdef GL_ARB_buffer_storage
+    for(size_t i = 0; i < fences.size(); i++) {
+        if(fences[i] != 0) glDeleteSync(fences[i]);
+    }
+    fences.clear();
+#endif
+
+    if(mapped != 0) {
+        glBindBuffer(target, bufferid);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+        mapped = 0;
+    }
+
+    if(bufferid != 0) glDeleteBuffers(1, &bufferid);
+
+    bufferid    = 0;
+    region_size = 0;
+    region      = 0;
+    pending     = false;
+}
+
+void RStreamBuffer::allocate(size_t size) {
+
+    unload();
+
+    //keep regions aligned for any vertex format
+    region_size = (size + 255) & ~((size_t) 255);
+
+    glGenBuffers(1, &bufferid);
+    glBindBuffer(target, bufferid);
+
+#ifdef GL_ARB_buffer_storage
+    persistent = GLEW_ARB_buffer_storage && GLEW_ARB_sync;
+
+    if(persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(target, region_size * region_count, 0, flags);
+
+        mapped = (char*) glMapBufferRange(target, 0, region_size * region_count, flags);
+
+        if(mapped != 0) {
+            fences.resize(region_count, 0);
+        } else {
+            debugLog("stream buffer: persistent mapping failed, falling back to orphaning");
+
+            glBindBuffer(target, 0);
+            glDeleteBuffers(1, &bufferid);
+
+            persistent = false;
+
+            glGenBuffers(1, &bufferid);
+            glBindBuffer(target, bufferid);
+        }
+    }
+#endif
+
+    if(!persistent) {
+        glBufferData(target, region_size, 0, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(target, 0);
+}
+
+//wait until the GPU has finished drawing from a region
+void RStreamBuffer::waitRegion(int index) {
+#ifdef GL_ARB_buffer_storage
+    if(fences[index] == 0) return;
+
+    while(glClientWaitSync(fences[index], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+
+    glDeleteSync(fences[index]);
+    fences[index] = 0;
+#endif
+}
+
+size_t RStreamBuffer::upload(const void* data, size_t size) {
+
+    if(bufferid == 0 || size > region_size) {
+        allocate(size > region_size ? std::max(size, region_size * 2) : size);
+    }
+
+    if(!persistent) {
+        glBindBuffer(target, bufferid);
+        glBufferData(target, region_size, 0, GL_STREAM_DRAW);
+        glBufferSubData(target, 0, size, data);
+        glBindBuffer(target, 0);
+
+        return 0;
+    }
+
+#ifdef GL_ARB_buffer_storage
+    //all draws from the last region have been issued, fence them before moving on
+    if(pending) {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        region = (region + 1) % region_count;
+    }
+#endif
+
+    waitRegion(region);
+
+    size_t offset = region * region_size;
+
+    memcpy(mapped + offset, data, size);
+
+    pending = true;
+
+    return offset;
+}
+
+void RStreamBuffer::bind() {
+    glBindBuffer(target, bufferid);
+}
+
+void RStreamBuffer::unbind() {
+    glBindBuffer(target, 0);
+}
@@ -0,0 +1,68 @@
+/*
+    Copyright (C) 2011 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GOURCE_STREAM_BUFFER_H
+#define GOURCE_STREAM_BUFFER_H
+
+#include <vector>
+
+#include "core/display.h"
+
+// Vertex data rewritten every frame. Each upload goes to the next region of
+// a ring, so the regions still being read by the GPU for the previous frames
+// are never overwritten.
+//
+// With ARB_buffer_storage the ring is mapped once for the life of the buffer
+// and regions are reused once the fence placed after their draws has passed.
+// Otherwise the buffer is orphaned before each upload so the driver can hand
+// back fresh storage instead of waiting.
+
+class RStreamBuffer {
+    GLenum target;
+
+    GLuint bufferid;
+
+    size_t region_size;
+    int region_count;
+    int region;
+    bool pending;
+
+    bool persistent;
+    char* mapped;
+
+#ifdef GL_ARB_buffer_storage
+    std::vector<GLsync> fences;
+#endif
+
+    void allocate(size_t size);
+    void waitRegion(int index);
+public:
+    RStreamBuffer(GLenum target = GL_ARRAY_BUFFER, int region_count = 3);
+    ~RStreamBuffer();
+
+    void unload();
+
+    // copy data into the buffer, returning its offset in the buffer
+    size_t upload(const void* data, size_t size);
+
+    void bind();
+    void unbind();
+
+    bool isPersistent() const { return persistent; };
+};
+
+#endif
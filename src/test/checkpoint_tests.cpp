@@ -0,0 +1,151 @@
+/*
+    Copyright (C) 2021 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../gource.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdio.h>
+#include <set>
+
+extern size_t gGourceCheckpointBudget;
+
+static const char* checkpoint_test_log = "checkpoint_tests.log";
+
+// a log adding, modifying and deleting files, with some directory deletes
+static void writeCheckpointTestLog() {
+
+    FILE* fh = fopen(checkpoint_test_log, "w");
+    BOOST_REQUIRE(fh != 0);
+
+    const char* dirs[] = { "src", "src/core", "src/formats", "data", "data/shaders" };
+
+    std::set<std::string> live;
+
+    unsigned int seed = 1;
+
+    for(int i = 0; i < 400; i++) {
+        long long timestamp = 1000000000LL + i * 3600LL;
+        int user = i % 4;
+
+        if(i % 97 == 96) {
+            fprintf(fh, "%lld|user%d|D|src/formats/\n", timestamp, user);
+            continue;
+        }
+
+        for(int j = 0; j < 3; j++) {
+            seed = seed * 1103515245 + 12345;
+
+            char path[256];
+            snprintf(path, sizeof(path), "%s/file%u.cpp", dirs[(seed >> 8) % 5], (seed >> 16) % 40);
+
+            const char* action = "A";
+
+            if(live.find(path) != live.end()) {
+                action = ((seed >> 4) % 3) == 0 ? "D" : "M";
+            }
+
+            if(action[0] == 'D') live.erase(path);
+            else live.insert(path);
+
+            fprintf(fh, "%lld|user%d|%s|%s\n", timestamp, user, action, path);
+        }
+    }
+
+    fclose(fh);
+}
+
+static void setCheckpointTestSettings() {
+    gGourceSettings.setGourceDefaults();
+
+    gGourceSettings.path            = checkpoint_test_log;
+    gGourceSettings.log_format      = "custom";
+    gGourceSettings.benchmark       = true;
+    gGourceSettings.repo_count      = 1;
+    gGourceSettings.stop_at_end     = true;
+    gGourceSettings.loop            = false;
+    gGourceSettings.days_per_second = 1.0f;
+
+    display.width  = 1024;
+    display.height = 768;
+}
+
+static Gource* loadCheckpointTestGource() {
+    setCheckpointTestSettings();
+
+    Gource* gource = new Gource();
+
+    while(gource->isLoading()) {
+        SDL_Delay(1);
+    }
+
+    return gource;
+}
+
+BOOST_AUTO_TEST_CASE( checkpoint_tests )
+{
+    writeCheckpointTestLog();
+
+    float seek_positions[] = { 0.3f, 0.55f, 0.8f };
+
+    std::vector<std::string> restored[3];
+    std::vector<std::string> replayed[3];
+
+    // play through the log, checkpointing a few files per frame so
+    // commits are processed while the checkpoints are being taken
+    gGourceCheckpointBudget = 7;
+
+    Gource* gource = loadCheckpointTestGource();
+
+    for(int frame = 0; frame < 100000 && !gource->isFinished(); frame++) {
+        gource->simulate(0.1f);
+    }
+
+    BOOST_CHECK(gource->isFinished());
+    BOOST_CHECK(gource->getCheckpointCount() > 3);
+
+    // seeking restores the nearest checkpoint and applies the commits since
+    for(int i = 0; i < 3; i++) {
+        gource->seekTo(seek_positions[i]);
+        gource->getFilePaths(restored[i]);
+    }
+
+    delete gource;
+
+    gGourceCheckpointBudget = 20000;
+
+    // the only checkpoint taken before the first seek is at the start of
+    // the log, so seeking applies every commit up to the position
+    gource = loadCheckpointTestGource();
+
+    gource->simulate(0.1f);
+
+    BOOST_REQUIRE_EQUAL(gource->getCheckpointCount(), (size_t) 1);
+
+    for(int i = 0; i < 3; i++) {
+        gource->seekTo(seek_positions[i]);
+        gource->getFilePaths(replayed[i]);
+    }
+
+    delete gource;
+
+    for(int i = 0; i < 3; i++) {
+        BOOST_CHECK(!replayed[i].empty());
+        BOOST_CHECK_EQUAL_COLLECTIONS(restored[i].begin(), restored[i].end(), replayed[i].begin(), replayed[i].end());
+    }
+
+    remove(checkpoint_test_log);
+}
@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2021 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../pathtrie.h"
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE( path_trie_tests )
+{
+    RPathTrie trie;
+
+    // only used as keys
+    RDirNode* root = (RDirNode*) 1;
+    RDirNode* src  = (RDirNode*) 2;
+    RDirNode* foo1 = (RDirNode*) 3;
+    RDirNode* foo2 = (RDirNode*) 4;
+
+    trie.add("/", root);
+    trie.add("/src/", src);
+    trie.add("/lib/foo/bar1/", foo1);
+    trie.add("/lib/foo/bar2/", foo2);
+
+    BOOST_CHECK_EQUAL(trie.size(), 4);
+
+    BOOST_CHECK(trie.find("/src/") == src);
+    BOOST_CHECK(trie.find("/src") == src);
+    BOOST_CHECK(trie.find("/lib/") == 0);
+    BOOST_CHECK(trie.find("/missing/") == 0);
+
+    BOOST_CHECK(trie.findClosest("/src/main/") == src);
+    BOOST_CHECK(trie.findClosest("/lib/foo/") == root);
+    BOOST_CHECK(trie.findClosest("/lib/foo/bar2/baz/") == foo2);
+
+    BOOST_CHECK(trie.isDir("/lib/"));
+    BOOST_CHECK(trie.isDir("/lib/foo"));
+    BOOST_CHECK(trie.isDir("/src/"));
+    BOOST_CHECK(trie.isDir("/src/main/") == false);
+    BOOST_CHECK(trie.isDir("/li/") == false);
+
+    std::list<RDirNode*> dirs;
+    trie.findDirs("/lib/", dirs);
+    BOOST_CHECK_EQUAL(dirs.size(), 2);
+    BOOST_CHECK(std::find(dirs.begin(), dirs.end(), foo1) != dirs.end());
+    BOOST_CHECK(std::find(dirs.begin(), dirs.end(), foo2) != dirs.end());
+
+    dirs.clear();
+    trie.findDirs("/", dirs);
+    BOOST_CHECK_EQUAL(dirs.size(), 1);
+    BOOST_CHECK(dirs.front() == root);
+
+    BOOST_CHECK_EQUAL(trie.commonPrefix("/lib/foo/bar3/"), "/lib/foo/");
+    BOOST_CHECK_EQUAL(trie.commonPrefix("/lib/other/"), "/lib/");
+    BOOST_CHECK_EQUAL(trie.commonPrefix("/docs/"), "/");
+    BOOST_CHECK_EQUAL(trie.commonPrefix("/src/main/"), "/src/");
+
+    // removing the last dir under a branch prunes it
+    trie.remove("/lib/foo/bar1/");
+    BOOST_CHECK_EQUAL(trie.size(), 3);
+    BOOST_CHECK(trie.isDir("/lib/foo/bar1/") == false);
+    BOOST_CHECK(trie.isDir("/lib/foo/"));
+
+    trie.remove("/lib/foo/bar2/");
+    BOOST_CHECK(trie.isDir("/lib/") == false);
+    BOOST_CHECK_EQUAL(trie.commonPrefix("/lib/foo/bar2/"), "/");
+
+    // remaining dirs are still reachable by index
+    bool found_src = false;
+    for(size_t i = 0; i < trie.size(); i++) {
+        if(trie.getDir(i) == src) found_src = true;
+    }
+    BOOST_CHECK(found_src);
+
+    // pruned nodes are reused
+    trie.add("/lib/foo/bar1/", foo1);
+    BOOST_CHECK(trie.find("/lib/foo/bar1/") == foo1);
+    BOOST_CHECK(trie.findClosest("/lib/foo/bar1/x/") == foo1);
+
+    trie.clear();
+    BOOST_CHECK_EQUAL(trie.size(), 0);
+    BOOST_CHECK(trie.isDir("/") == false);
+}
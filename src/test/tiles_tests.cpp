@@ -0,0 +1,65 @@
+/*
+    Copyright (C) 2021 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../tiles.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE( tiles_tests )
+{
+    // 3x2 tiles of 100x50 pixels
+    RFrameTiles tiles;
+    tiles.setGrid(3, 2);
+
+    int width  = 300;
+    int height = 100;
+
+    // label positions in window coordinates, from the top left
+    int points[][2] = { { 5, 5 }, { 150, 25 }, { 299, 99 }, { 100, 50 }, { 250, 60 } };
+
+    for(int p = 0; p < 5; p++) {
+        int px = points[p][0];
+        int py = points[p][1];
+
+        // clip space position in the whole frame (y up)
+        float x = (px + 0.5f) / width  * 2.0f - 1.0f;
+        float y = 1.0f - (py + 0.5f) / height * 2.0f;
+
+        int visible = 0;
+
+        for(int row = 0; row < 2; row++) {
+            for(int column = 0; column < 3; column++) {
+                GLfloat m[16];
+                tiles.getTileMatrix(column, row, m);
+
+                float tx = m[0] * x + m[12];
+                float ty = m[5] * y + m[13];
+
+                if(tx < -1.0f || tx >= 1.0f || ty < -1.0f || ty >= 1.0f) continue;
+
+                visible++;
+
+                // each label is drawn in the tile that covers it, at the same place
+                BOOST_CHECK_EQUAL(column, px / 100);
+                BOOST_CHECK_EQUAL(row,    py / 50);
+                BOOST_CHECK_CLOSE((tx + 1.0f) * 50.0f, (px % 100) + 0.5f, 0.01);
+                BOOST_CHECK_CLOSE((1.0f - ty) * 25.0f, (py % 50) + 0.5f, 0.01);
+            }
+        }
+
+        BOOST_CHECK_EQUAL(visible, 1);
+    }
+}
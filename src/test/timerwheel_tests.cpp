@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2021 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../timerwheel.h"
+
+#include <boost/test/unit_test.hpp>
+
+class TestTimer : public RTimer {
+public:
+    RTimerWheel* wheel;
+    double fired;
+    int count;
+
+    TestTimer(RTimerWheel* wheel) : wheel(wheel), fired(-1.0), count(0) {}
+
+    void timerExpired() {
+        fired = wheel->getTime();
+        count++;
+    }
+};
+
+BOOST_AUTO_TEST_CASE( timer_wheel_tests )
+{
+    RTimerWheel wheel(8, 0.25f);
+
+    TestTimer soon(&wheel);
+    TestTimer later(&wheel);
+    TestTimer now(&wheel);
+    TestTimer cancelled(&wheel);
+
+    wheel.schedule(&soon, 0.3f);
+    wheel.schedule(&later, 10.0f);
+    wheel.schedule(&now, 0.0f);
+    wheel.schedule(&cancelled, 1.0f);
+
+    BOOST_CHECK_EQUAL(wheel.size(), 4);
+
+    wheel.cancel(&cancelled);
+    BOOST_CHECK(!cancelled.isScheduled());
+    BOOST_CHECK_EQUAL(wheel.size(), 3);
+
+    for(int i = 0; i < 600; i++) {
+        wheel.advance(1.0f / 60.0f);
+    }
+
+    // timers fire no earlier than scheduled and at most one tick late
+    BOOST_CHECK(now.fired >= 0.0f && now.fired <= 0.5f);
+    BOOST_CHECK(soon.fired >= 0.3f && soon.fired <= 0.55f);
+
+    // longer than one turn of the wheel
+    BOOST_CHECK(later.fired >= 10.0f && later.fired <= 10.25f + 1.0f / 60.0f);
+
+    BOOST_CHECK_EQUAL(cancelled.count, 0);
+    BOOST_CHECK_EQUAL(soon.count, 1);
+    BOOST_CHECK_EQUAL(wheel.size(), 0);
+
+    // rescheduling replaces the pending time
+    wheel.schedule(&soon, 1.0f);
+    wheel.schedule(&soon, 5.0f);
+    BOOST_CHECK_EQUAL(wheel.size(), 1);
+
+    // large steps still fire everything due
+    wheel.advance(100.0f);
+    BOOST_CHECK_EQUAL(soon.count, 2);
+    BOOST_CHECK_EQUAL(wheel.size(), 0);
+
+    // frame steps still add up after running for weeks
+    wheel.advance(2000000.0f);
+
+    double start = wheel.getTime();
+
+    wheel.schedule(&soon, 0.5f);
+
+    for(int i = 0; i < 60; i++) {
+        wheel.advance(1.0f / 60.0f);
+    }
+
+    BOOST_CHECK_CLOSE(wheel.getTime() - start, 1.0, 0.01);
+    BOOST_CHECK_EQUAL(soon.count, 3);
+}
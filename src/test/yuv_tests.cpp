@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2021 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../yuv.h"
+
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE( yuv_tests )
+{
+    // 2x2 frame, bottom row white, top row black
+    unsigned char rgba[16] = {
+        255, 255, 255, 255,  255, 255, 255, 255,
+          0,   0,   0, 255,    0,   0,   0, 255
+    };
+
+    std::vector<unsigned char> yuv(yuv420FrameSize(2, 2));
+    BOOST_CHECK_EQUAL(yuv.size(), 6);
+
+    rgbaToYUV420(rgba, 2, 2, RYUV_I420, &(yuv[0]));
+
+    // rows are flipped
+    BOOST_CHECK_EQUAL(yuv[0], 16);
+    BOOST_CHECK_EQUAL(yuv[1], 16);
+    BOOST_CHECK_EQUAL(yuv[2], 235);
+    BOOST_CHECK_EQUAL(yuv[3], 235);
+    BOOST_CHECK_EQUAL(yuv[4], 128);
+    BOOST_CHECK_EQUAL(yuv[5], 128);
+
+    // SIMD and scalar paths agree, including odd sizes
+    int sizes[][2] = { { 64, 32 }, { 37, 11 }, { 9, 1 } };
+
+    srand(1);
+
+    for(int s = 0; s < 3; s++) {
+        int width  = sizes[s][0];
+        int height = sizes[s][1];
+
+        std::vector<unsigned char> frame(width * height * 4);
+        for(size_t i = 0; i < frame.size(); i++) frame[i] = rand() % 256;
+
+        for(int layout = RYUV_I420; layout <= RYUV_NV12; layout++) {
+            std::vector<unsigned char> fast(yuv420FrameSize(width, height));
+            std::vector<unsigned char> reference(fast.size());
+
+            rgbaToYUV420(&(frame[0]), width, height, (RYUVLayout) layout, &(fast[0]));
+            rgbaToYUV420Scalar(&(frame[0]), width, height, (RYUVLayout) layout, &(reference[0]));
+
+            BOOST_CHECK(fast == reference);
+        }
+    }
+
+    // NV12 interleaves the I420 chroma planes
+    std::vector<unsigned char> frame(16 * 4 * 4);
+    for(size_t i = 0; i < frame.size(); i++) frame[i] = rand() % 256;
+
+    std::vector<unsigned char> i420(yuv420FrameSize(16, 4));
+    std::vector<unsigned char> nv12(i420.size());
+
+    rgbaToYUV420(&(frame[0]), 16, 4, RYUV_I420, &(i420[0]));
+    rgbaToYUV420(&(frame[0]), 16, 4, RYUV_NV12, &(nv12[0]));
+
+    BOOST_CHECK(std::equal(i420.begin(), i420.begin() + 64, nv12.begin()));
+
+    for(int i = 0; i < 16; i++) {
+        BOOST_CHECK_EQUAL(nv12[64 + i*2],     i420[64 + i]);
+        BOOST_CHECK_EQUAL(nv12[64 + i*2 + 1], i420[64 + 16 + i]);
+    }
+}
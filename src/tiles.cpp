@@ -0,0 +1,131 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tiles.h"
+
+RFrameTiles gGourceFrameTiles;
+
+RFrameTiles::RFrameTiles() {
+    columns     = 1;
+    rows        = 1;
+    tile_width  = 0;
+    tile_height = 0;
+    column      = -1;
+    row         = -1;
+    started     = false;
+}
+
+void RFrameTiles::setGrid(int columns, int rows) {
+    this->columns = columns;
+    this->rows    = rows;
+}
+
+//switch the display to the size of the whole frame
+void RFrameTiles::begin() {
+    if(started) return;
+
+    tile_width  = display.width;
+    tile_height = display.height;
+
+    display.width  = tile_width  * columns;
+    display.height = tile_height * rows;
+
+    started = true;
+}
+
+void RFrameTiles::end() {
+    if(!started) return;
+
+    clearTile();
+
+    display.width  = tile_width;
+    display.height = tile_height;
+
+    started = false;
+}
+
+//tiles are numbered from the top left
+void RFrameTiles::setTile(int column, int row) {
+    this->column = column;
+    this->row    = row;
+
+    glViewport(0, 0, tile_width, tile_height);
+}
+
+void RFrameTiles::clearTile() {
+    column = -1;
+    row    = -1;
+}
+
+int RFrameTiles::getTileX() const {
+    return column * tile_width;
+}
+
+int RFrameTiles::getTileY() const {
+    return (rows - row - 1) * tile_height;
+}
+
+//viewport of the whole frame, for projecting to screen coordinates
+void RFrameTiles::getViewport(GLint* viewport) const {
+
+    if(!started) {
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        return;
+    }
+
+    viewport[0] = 0;
+    viewport[1] = 0;
+    viewport[2] = display.width;
+    viewport[3] = display.height;
+}
+
+//column major matrix mapping a tile's part of the frame to clip space
+void RFrameTiles::getTileMatrix(int column, int row, GLfloat* matrix) const {
+
+    int tile_row = rows - row - 1;
+
+    for(int i = 0; i < 16; i++) matrix[i] = 0.0f;
+
+    matrix[0]  = (GLfloat) columns;
+    matrix[5]  = (GLfloat) rows;
+    matrix[10] = 1.0f;
+    matrix[12] = (GLfloat) (columns - 2*column - 1);
+    matrix[13] = (GLfloat) (rows - 2*tile_row - 1);
+    matrix[15] = 1.0f;
+}
+
+//scale and offset the current projection so the tile fills the viewport
+void RFrameTiles::applyProjection() const {
+
+    if(column < 0) return;
+
+    GLint matrix_mode;
+    GLfloat projection[16];
+
+    glGetIntegerv(GL_MATRIX_MODE, &matrix_mode);
+
+    glMatrixMode(GL_PROJECTION);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+
+    GLfloat tile[16];
+    getTileMatrix(column, row, tile);
+
+    glLoadMatrixf(tile);
+    glMultMatrixf(projection);
+
+    glMatrixMode(matrix_mode);
+}
@@ -0,0 +1,71 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RTILES_H
+#define RTILES_H
+
+#include "core/display.h"
+
+// Renders frames larger than the framebuffer as a grid of tiles, each the
+// size of the framebuffer. Between begin() and end() display.width and
+// display.height are the size of the whole frame so layout is unchanged,
+// and while a tile is selected applyProjection() narrows the current
+// projection to that tile's part of the frame.
+
+class RFrameTiles {
+    int columns;
+    int rows;
+
+    int tile_width;
+    int tile_height;
+
+    int column;
+    int row;
+
+    bool started;
+public:
+    RFrameTiles();
+
+    void setGrid(int columns, int rows);
+
+    bool enabled() const { return columns * rows > 1; };
+
+    int getColumns() const    { return columns; };
+    int getRows() const       { return rows; };
+    int getTileWidth() const  { return tile_width; };
+    int getTileHeight() const { return tile_height; };
+
+    void begin();
+    void end();
+
+    void setTile(int column, int row);
+    void clearTile();
+
+    // offset of the current tile in the frame, from the bottom left
+    int getTileX() const;
+    int getTileY() const;
+
+    void getViewport(GLint* viewport) const;
+
+    void getTileMatrix(int column, int row, GLfloat* matrix) const;
+
+    void applyProjection() const;
+};
+
+extern RFrameTiles gGourceFrameTiles;
+
+#endif
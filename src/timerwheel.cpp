@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "timerwheel.h"
+
+#include <math.h>
+#include <algorithm>
+
+RTimerWheel::RTimerWheel(size_t slot_count, float resolution) : resolution(resolution) {
+    slots.resize(slot_count);
+    now   = 0.0;
+    tick  = 0;
+    count = 0;
+}
+
+void RTimerWheel::schedule(RTimer* timer, float delay) {
+
+    cancel(timer);
+
+    timer->expires = now + std::max(0.0f, delay);
+
+    //the first tick at or after the expiry time that hasn't been visited yet
+    long expiry_tick = std::max(tick + 1, (long) ceil(timer->expires / resolution));
+
+    timer->slot = expiry_tick % slots.size();
+
+    std::list<RTimer*>& slot = slots[timer->slot];
+    timer->position = slot.insert(slot.end(), timer);
+
+    count++;
+}
+
+void RTimerWheel::cancel(RTimer* timer) {
+    if(timer->slot == -1) return;
+
+    slots[timer->slot].erase(timer->position);
+    timer->slot = -1;
+
+    count--;
+}
+
+void RTimerWheel::advance(float dt) {
+
+    now += dt;
+
+    long current_tick = (long) floor(now / resolution);
+
+    //visit each slot at most once however far the clock moved
+    long first_tick = std::max(tick + 1, current_tick - (long) slots.size() + 1);
+
+    for(long t = first_tick; t <= current_tick; t++) {
+
+        //detach the slot so expired timers can be rescheduled from their callback
+        std::list<RTimer*> due;
+        due.splice(due.end(), slots[t % slots.size()]);
+
+        while(!due.empty()) {
+            RTimer* timer = due.front();
+
+            if(timer->expires > now) {
+                //expires on a later turn of the wheel
+                std::list<RTimer*>& slot = slots[timer->slot];
+                slot.splice(slot.end(), due, due.begin());
+                timer->position = --slot.end();
+                continue;
+            }
+
+            due.pop_front();
+            timer->slot = -1;
+            count--;
+
+            timer->timerExpired();
+        }
+    }
+
+    if(current_tick > tick) tick = current_tick;
+}
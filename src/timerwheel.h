@@ -0,0 +1,71 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RTIMERWHEEL_H
+#define RTIMERWHEEL_H
+
+#include <list>
+#include <vector>
+#include <stddef.h>
+
+class RTimerWheel;
+
+// Something that can be scheduled on a timer wheel. Only one timer per object
+// can be pending; scheduling it again replaces the previous time.
+
+class RTimer {
+    friend class RTimerWheel;
+
+    double expires;
+    int slot;
+    std::list<RTimer*>::iterator position;
+public:
+    RTimer() : expires(0.0), slot(-1) {};
+    virtual ~RTimer() {};
+
+    bool isScheduled() const { return slot != -1; };
+
+    virtual void timerExpired() = 0;
+};
+
+// Hashed timer wheel. Timers are kept in slots by the tick they expire in so
+// advancing the clock only visits the slots that have come due, and adding or
+// cancelling a timer is O(1). Timers further away than one turn of the wheel
+// stay in their slot until the turn they expire in.
+
+class RTimerWheel {
+    float resolution;
+    //a float clock stops advancing by a frame after a few days
+    double now;
+    long tick;
+
+    std::vector< std::list<RTimer*> > slots;
+
+    size_t count;
+public:
+    RTimerWheel(size_t slot_count = 256, float resolution = 0.25f);
+
+    void schedule(RTimer* timer, float delay);
+    void cancel(RTimer* timer);
+
+    void advance(float dt);
+
+    double getTime() const { return now; };
+    size_t size() const   { return count; };
+};
+
+#endif
@@ -21,6 +21,8 @@ float gGourceBeamDist          = 100.0;
 float gGourceActionDist        = 50.0;
 float gGourcePersonalSpaceDist = 100.0;
 
+RObjectPool gGourceUserPool(sizeof(RUser), 64);
+
 RUser::RUser(const std::string& name, vec2 pos, int tagid) : Pawn(name,pos,tagid) {
 
     this->name = name;
@@ -34,6 +36,8 @@ RUser::RUser(const std::string& name, vec2 pos, int tagid) : Pawn(name,pos,tagid
 
     highlighted=false;
 
+    user_index = -1;
+
     assignUserImage();
 
     setSelected(false);
@@ -47,6 +51,14 @@ RUser::RUser(const std::string& name, vec2 pos, int tagid) : Pawn(name,pos,tagid
     actionCount = activeCount = 0;
 }
 
+void* RUser::operator new(size_t size) {
+    return gGourceUserPool.allocate(size);
+}
+
+void RUser::operator delete(void* user) {
+    gGourceUserPool.release(user);
+}
+
 void RUser::addAction(RAction* action) {
 
     if(action->source != this) return;
@@ -54,35 +66,22 @@ void RUser::addAction(RAction* action) {
     if(isIdle()) showName();
     //name_interval = name_interval > 0.0 ? std::max(name_interval,nametime-1.0f) : nametime;
 
-    actions.push_back(action);
+    action->source_position = actions.insert(actions.end(), action);
     actionCount++;
 }
 
-// remove references to this file
-void RUser::fileRemoved(RFile* f) {
-
-    for(std::list<RAction*>::iterator it = actions.begin(); it != actions.end(); ) {
-        RAction* a = *it;
-        if(a->target == f) {
-            it = actions.erase(it);
-            delete a;
-            actionCount--;
-            continue;
-        }
+// remove and delete an action of this user
+void RUser::removeAction(RAction* action) {
 
-        it++;
+    if(action->active) {
+        activeActions.erase(action->source_position);
+        activeCount--;
+    } else {
+        actions.erase(action->source_position);
+        actionCount--;
     }
 
-    for(std::list<RAction*>::iterator it = activeActions.begin(); it != activeActions.end(); ) {
-        RAction* a = *it;
-        if(a->target == f) {
-            it = activeActions.erase(it);
-            delete a;
-            continue;
-        }
-
-        it++;
-    }
+    delete action;
 }
 
 void RUser::applyForceUser(RUser* u) {
@@ -180,7 +179,7 @@ void RUser::assignUserImage() {
 
     TextureResource* graphic = 0;
 
-    if(gGourceSettings.user_image_dir.size() > 0) {
+    if(gGourceSettings.user_image_dir.size() > 0 && !gGourceSettings.benchmark) {
 
         //try their username
         // TODO: replace with map of name -> image of all pngs and jpgs in directory
@@ -205,7 +204,7 @@ void RUser::assignUserImage() {
     //      perhaps the mipmap option should be an enum: eg TEX_MIPMAP_TRILINEAR
 
     //nope
-    if(!graphic) {
+    if(!graphic && !gGourceSettings.benchmark) {
         if(gGourceSettings.default_user_image.size() > 0) {
             if(!gGourceSettings.colour_user_images) usercol = vec3(1.0, 1.0, 1.0);
             graphic = texturemanager.grabFile(gGourceSettings.default_user_image, true, GL_CLAMP_TO_EDGE);
@@ -245,10 +244,10 @@ void RUser::logic(float t, float dt) {
 
         //add all files which are too old
         if(gGourceSettings.max_file_lag>=0.0 && action->t < t - gGourceSettings.max_file_lag) {
-            it = actions.erase(it);
+            activeActions.splice(activeActions.end(), actions, it++);
             actionCount--;
             action->rate = 2.0;
-            activeActions.push_back(action);
+            action->active = true;
             activeCount++;
             continue;
         }
@@ -259,8 +258,8 @@ void RUser::logic(float t, float dt) {
 
         //queue first action in range
         if(action_dist < gGourceBeamDist) {
-            it = actions.erase(it);
-            activeActions.push_back(action);
+            activeActions.splice(activeActions.end(), actions, it);
+            action->active = true;
             actionCount--; activeCount++;
             break;
         }
@@ -302,6 +301,8 @@ void RUser::logic(float t, float dt) {
 }
 
 void RUser::updateFont() {
+    if(gGourceSettings.benchmark) return;
+
     if(selected) {
         font = fontmanager.grab(gGourceSettings.font_file, 18);
         font.dropShadow(true);
@@ -23,6 +23,7 @@
 #include "pawn.h"
 #include "action.h"
 #include "file.h"
+#include "pool.h"
 
 #include "sys/stat.h"
 
@@ -52,6 +53,9 @@ class RUser : public Pawn {
 
     bool highlighted;
 
+    //position in Gource::users
+    int user_index;
+
     bool nameVisible() const;
 
     void updateFont();
@@ -60,13 +64,19 @@ class RUser : public Pawn {
 public:
     RUser(const std::string& name, vec2 pos, int tagid);
 
+    static void* operator new(size_t size);
+    static void operator delete(void* user);
+
     vec3 getColour() const;
     void colourize();
 
     const std::string& getName() const;
 
-    void fileRemoved(RFile* f);
+    void setIndex(int index) { user_index = index; };
+    int getIndex() const { return user_index; };
+
     void addAction(RAction* action);
+    void removeAction(RAction* action);
 
     bool isIdle();
     bool isFading();
@@ -127,4 +137,6 @@ class UserForceFunctor : public VisitFunctor<QuadItem>{
 
 };
 
+extern RObjectPool gGourceUserPool;
+
 #endif
@@ -0,0 +1,221 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "yuv.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RYUV_SSE2
+#include <emmintrin.h>
+#endif
+
+// fixed point BT.601 coefficients scaled by 256
+
+#define RYUV_Y(r,g,b) (((  66*(r) + 129*(g) +  25*(b) + 128) >> 8) +  16)
+#define RYUV_U(r,g,b) ((( -38*(r) -  74*(g) + 112*(b) + 128) >> 8) + 128)
+#define RYUV_V(r,g,b) ((( 112*(r) -  94*(g) -  18*(b) + 128) >> 8) + 128)
+
+static inline int yuvAverage(int a, int b) {
+    return (a + b + 1) >> 1;
+}
+
+size_t yuv420FrameSize(int width, int height) {
+    size_t chroma_width  = (width+1)/2;
+    size_t chroma_height = (height+1)/2;
+
+    return (size_t) width * height + chroma_width * chroma_height * 2;
+}
+
+static void yuvLumaScalar(const unsigned char* src, int start, int width, unsigned char* dest) {
+
+    for(int x = start; x < width; x++) {
+        const unsigned char* p = src + x*4;
+        dest[x] = RYUV_Y(p[0], p[1], p[2]);
+    }
+}
+
+// average each 2x2 block the same way as the SIMD path (rows first, then columns)
+static void yuvChromaScalar(const unsigned char* row0, const unsigned char* row1, int start, int width, unsigned char* u, unsigned char* v, int step) {
+
+    for(int x = start; x < width; x += 2) {
+
+        int x1 = x+1 < width ? x+1 : x;
+
+        const unsigned char* p00 = row0 + x*4;
+        const unsigned char* p01 = row0 + x1*4;
+        const unsigned char* p10 = row1 + x*4;
+        const unsigned char* p11 = row1 + x1*4;
+
+        int c[3];
+
+        for(int i = 0; i < 3; i++) {
+            c[i] = yuvAverage(yuvAverage(p00[i], p10[i]), yuvAverage(p01[i], p11[i]));
+        }
+
+        int cx = (x/2) * step;
+
+        u[cx] = RYUV_U(c[0], c[1], c[2]);
+        v[cx] = RYUV_V(c[0], c[1], c[2]);
+    }
+}
+
+#ifdef RYUV_SSE2
+
+// dot product of the RGBA channels of 4 pixels with coef
+static inline __m128i yuvDot4(__m128i pixels, __m128i coef) {
+    __m128i zero = _mm_setzero_si128();
+
+    __m128i m0 = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coef);
+    __m128i m1 = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coef);
+
+    __m128i rg = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(m0), _mm_castsi128_ps(m1), _MM_SHUFFLE(2,0,2,0)));
+    __m128i ba = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(m0), _mm_castsi128_ps(m1), _MM_SHUFFLE(3,1,3,1)));
+
+    return _mm_add_epi32(rg, ba);
+}
+
+static inline void yuvStore4(unsigned char* dest, __m128i values) {
+    int32_t packed = _mm_cvtsi128_si32(values);
+    memcpy(dest, &packed, 4);
+}
+
+static int yuvLumaSSE2(const unsigned char* src, int width, unsigned char* dest) {
+
+    const __m128i coef = _mm_setr_epi16(66, 129, 25, 0, 66, 129, 25, 0);
+    const __m128i bias = _mm_set1_epi32(128 + (16 << 8));
+
+    int x = 0;
+
+    for(; x + 8 <= width; x += 8) {
+        __m128i p0 = _mm_loadu_si128((const __m128i*) (src + x*4));
+        __m128i p1 = _mm_loadu_si128((const __m128i*) (src + x*4 + 16));
+
+        __m128i y0 = _mm_srai_epi32(_mm_add_epi32(yuvDot4(p0, coef), bias), 8);
+        __m128i y1 = _mm_srai_epi32(_mm_add_epi32(yuvDot4(p1, coef), bias), 8);
+
+        __m128i y = _mm_packus_epi16(_mm_packs_epi32(y0, y1), _mm_setzero_si128());
+
+        _mm_storel_epi64((__m128i*) (dest + x), y);
+    }
+
+    return x;
+}
+
+static int yuvChromaSSE2(const unsigned char* row0, const unsigned char* row1, int width, unsigned char* u, unsigned char* v, int step) {
+
+    const __m128i ucoef = _mm_setr_epi16(-38, -74, 112, 0, -38, -74, 112, 0);
+    const __m128i vcoef = _mm_setr_epi16(112, -94, -18, 0, 112, -94, -18, 0);
+    const __m128i bias  = _mm_set1_epi32(128 + (128 << 8));
+
+    int x = 0;
+
+    for(; x + 8 <= width; x += 8) {
+
+        __m128i a0 = _mm_loadu_si128((const __m128i*) (row0 + x*4));
+        __m128i a1 = _mm_loadu_si128((const __m128i*) (row0 + x*4 + 16));
+        __m128i b0 = _mm_loadu_si128((const __m128i*) (row1 + x*4));
+        __m128i b1 = _mm_loadu_si128((const __m128i*) (row1 + x*4 + 16));
+
+        //average the rows, then neighbouring pixels (left in dwords 0 and 2)
+        __m128i v0 = _mm_avg_epu8(a0, b0);
+        __m128i v1 = _mm_avg_epu8(a1, b1);
+
+        v0 = _mm_avg_epu8(v0, _mm_srli_epi64(v0, 32));
+        v1 = _mm_avg_epu8(v1, _mm_srli_epi64(v1, 32));
+
+        __m128i c = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(v0), _mm_castsi128_ps(v1), _MM_SHUFFLE(2,0,2,0)));
+
+        __m128i cu = _mm_srai_epi32(_mm_add_epi32(yuvDot4(c, ucoef), bias), 8);
+        __m128i cv = _mm_srai_epi32(_mm_add_epi32(yuvDot4(c, vcoef), bias), 8);
+
+        //u0..u3 v0..v3
+        __m128i uv = _mm_packus_epi16(_mm_packs_epi32(cu, cv), _mm_setzero_si128());
+
+        int cx = (x/2) * step;
+
+        if(step == 2) {
+            _mm_storel_epi64((__m128i*) (u + cx), _mm_unpacklo_epi8(uv, _mm_srli_si128(uv, 4)));
+        } else {
+            yuvStore4(u + cx, uv);
+            yuvStore4(v + cx, _mm_srli_si128(uv, 4));
+        }
+    }
+
+    return x;
+}
+
+#endif
+
+static void yuvConvert(const unsigned char* rgba, int width, int height, RYUVLayout layout, unsigned char* output, bool simd) {
+
+    size_t rowstride     = (size_t) width * 4;
+    size_t chroma_width  = (width+1)/2;
+    size_t chroma_height = (height+1)/2;
+
+    unsigned char* luma   = output;
+    unsigned char* chroma = output + (size_t) width * height;
+
+    for(int y = 0; y < height; y++) {
+        const unsigned char* src = rgba + (height - y - 1) * rowstride;
+        unsigned char* dest      = luma + (size_t) y * width;
+
+        int x = 0;
+#ifdef RYUV_SSE2
+        if(simd) x = yuvLumaSSE2(src, width, dest);
+#endif
+        yuvLumaScalar(src, x, width, dest);
+    }
+
+    for(size_t cy = 0; cy < chroma_height; cy++) {
+
+        int y0 = cy*2;
+        int y1 = y0+1 < height ? y0+1 : y0;
+
+        const unsigned char* row0 = rgba + (height - y0 - 1) * rowstride;
+        const unsigned char* row1 = rgba + (height - y1 - 1) * rowstride;
+
+        unsigned char* u;
+        unsigned char* v;
+        int step;
+
+        if(layout == RYUV_NV12) {
+            u    = chroma + cy * chroma_width * 2;
+            v    = u + 1;
+            step = 2;
+        } else {
+            u    = chroma + cy * chroma_width;
+            v    = chroma + chroma_width * chroma_height + cy * chroma_width;
+            step = 1;
+        }
+
+        int x = 0;
+#ifdef RYUV_SSE2
+        if(simd) x = yuvChromaSSE2(row0, row1, width, u, v, step);
+#endif
+        yuvChromaScalar(row0, row1, x, width, u, v, step);
+    }
+}
+
+void rgbaToYUV420(const unsigned char* rgba, int width, int height, RYUVLayout layout, unsigned char* output) {
+    yuvConvert(rgba, width, height, layout, output, true);
+}
+
+void rgbaToYUV420Scalar(const unsigned char* rgba, int width, int height, RYUVLayout layout, unsigned char* output) {
+    yuvConvert(rgba, width, height, layout, output, false);
+}
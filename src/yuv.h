@@ -0,0 +1,39 @@
+/*
+    Copyright (C) 2009 Andrew Caudwell (acaudwell@gmail.com)
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version
+    3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RYUV_H
+#define RYUV_H
+
+#include <stddef.h>
+
+// RGBA to YUV 4:2:0 conversion (BT.601, limited range) for video output.
+// Input rows are ordered bottom to top as read back by glReadPixels and
+// are flipped during conversion. Chroma is the average of each 2x2 block.
+
+enum RYUVLayout {
+    RYUV_I420, // Y plane, U plane, V plane
+    RYUV_NV12  // Y plane, interleaved UV plane
+};
+
+size_t yuv420FrameSize(int width, int height);
+
+void rgbaToYUV420(const unsigned char* rgba, int width, int height, RYUVLayout layout, unsigned char* output);
+
+// reference implementation without SIMD
+void rgbaToYUV420Scalar(const unsigned char* rgba, int width, int height, RYUVLayout layout, unsigned char* output);
+
+#endif